@@ -0,0 +1,42 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Counts heap allocations once armed, in builds that replace the global operator new
+ *
+ * Only TRAFFIC_COUNT_ALLOCATIONS builds link the replacement, so elsewhere
+ * the count stays zero.
+ */
+class allocation_counter {
+public:
+    typedef std::uint64_t count_type;
+
+    allocation_counter() = delete;
+
+    /**
+     * @brief Start counting from zero
+     */
+    static void arm() {
+        s_count.store(0, std::memory_order_relaxed);
+        s_armed.store(true, std::memory_order_release);
+    }
+
+    static count_type count() {
+        return s_count.load(std::memory_order_relaxed);
+    }
+
+    static void record() {
+        if (s_armed.load(std::memory_order_relaxed)) {
+            s_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    static inline std::atomic<bool> s_armed{false};
+    static inline std::atomic<count_type> s_count{0};
+};
+
+#endif // ALLOCATION_COUNTER_HPP
@@ -6,19 +6,55 @@ extern "C" {
 } // extern "C"
 
 #include <array>
+#include <atomic>
 #include <bitset>
+#include <ostream>
+#include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
-#include <asio/streambuf.hpp>
+#include <asio/bind_executor.hpp>
+#include <asio/post.hpp>
+#include <asio/signal_set.hpp>
+#include <asio/steady_timer.hpp>
+#include <asio/strand.hpp>
 
+#include "allocation_counter.hpp"
 #include "arguments.hpp"
+#include "capture_file.hpp"
+#include "charlie_table.hpp"
+#include "device_table.hpp"
+#include "evdev_descriptor.hpp"
+#include "event_logger.hpp"
+#include "frame_buffer.hpp"
 #include "gpio_chip_descriptor.hpp"
+#include "gpio_line_cache.hpp"
+#include "gpio_line_debouncer.hpp"
 #include "gpio_line_descriptor.hpp"
+#include "gpio_line_sequence_tracker.hpp"
+#include "handler_allocator.hpp"
+#include "histogram.hpp"
 #include "inotify_descriptor.hpp"
+#include "io_ring.hpp"
+#include "joystick_clock.hpp"
 #include "joystick_descriptor.hpp"
+#include "joystick_event_coalescer.hpp"
+#include "joystick_event_columns.hpp"
+#include "led_map.hpp"
+#include "scan_scheduler.hpp"
 #include "utility.hpp"
 
+/**
+ * @brief Drives the LEDs from joysticks and GPIO inputs
+ *
+ * The io_context may run on any number of threads.  The device registry,
+ * hotplug and replay run on one strand, each input device reads on a strand
+ * of its own, and the GPIO input line and report share another.  Devices
+ * publish into the frame buffer, which any strand may write, and only the
+ * scan chain or thread reads it.  With --io-uring, reads go through an
+ * io_uring the io_context is woken by, instead of epoll and read(2).
+ */
 class Application {
 public:
     Application() = delete;
@@ -27,86 +63,305 @@ public:
     Application(Application &&) = delete;
     Application & operator=(const Application &) = delete;
     Application & operator=(Application &&) = delete;
-    ~Application() = default;
+    ~Application();
+
+    /**
+     * @brief Write percentiles of the scan, GPIO ioctl and input-to-LED timings
+     */
+    void report(std::ostream & stream) const;
 
 private:
     typedef std::bitset<64> mask_type;
-    typedef std::pair<std::size_t, std::size_t> charlie_type;
 
     static const std::array<std::uint32_t, 4> s_inputs;
     static const std::array<std::uint32_t, 5> s_outputs;
     static const std::array<std::uint32_t, 1> s_brightness;
+    static const std::array<charlie_type, 20> s_charlies;
+    static const std::array<std::uint8_t, 256> s_gamma;
+    static const std::array<struct gpio_v2_line_config, 20> s_slots;
+    static const std::array<std::array<struct gpio_v2_line_config, (1 << 5)>, 5> s_rows;
+    static const struct gpio_v2_line_config s_idle;
+    static const std::chrono::seconds s_report_period;
+    static constexpr std::size_t s_devices = 64;
+    static constexpr std::size_t s_joystick_batch = 64;
+    static constexpr std::size_t s_evdev_batch = 64;
+    static constexpr std::size_t s_inotify_batch = 16;
+    static constexpr std::size_t s_gpio_batch = 16;
+    static const std::string_view s_default_map;
+
+    typedef asio::strand<asio::io_context::executor_type> strand_type;
 
     struct joystick_type{
-        std::pair<dev_t,ino_t> key;
+        joystick_type(asio::io_context & context, std::string_view name) :
+            name(name),
+            strand(asio::make_strand(context)),
+            descriptor(context)
+        {}
+        joystick_type(asio::io_context & context, std::string_view name, int fd) :
+            name(name),
+            strand(asio::make_strand(context)),
+            descriptor(context, fd)
+        {}
+
+        std::string name;
+        strand_type strand;
+        // closing belongs to the registry strand, reading and closed to the device strand
+        bool closing = false;
+        bool reading = false;
+        bool closed = false;
         joystick_descriptor descriptor;
+        joystick_clock clock;
+        joystick_event_coalescer events;
+        handler_memory memory;
+    };
+
+    /**
+     * @brief An evdev device read through the joydev numbering of its buttons and axes
+     *
+     * Button and axis numbers follow joydev: joystick and gamepad keys come
+     * first, then the remaining keys from BTN_MISC, then every absolute axis
+     * in code order.  Unmapped codes hold -1.
+     */
+    struct evdev_type{
+        evdev_type(asio::io_context & context, std::string_view name) :
+            name(name),
+            strand(asio::make_strand(context)),
+            descriptor(context)
+        {}
+        evdev_type(asio::io_context & context, std::string_view name, int fd) :
+            name(name),
+            strand(asio::make_strand(context)),
+            descriptor(context, fd)
+        {}
+
+        std::string name;
+        strand_type strand;
+        // closing belongs to the registry strand, reading and closed to the device strand
+        bool closing = false;
+        bool reading = false;
+        bool closed = false;
+        evdev_descriptor descriptor;
+        joystick_event_coalescer events;
+        std::array<std::int16_t, KEY_CNT> buttons;
+        std::array<std::int16_t, ABS_CNT> axes;
+        std::array<struct input_absinfo, ABS_CNT> absinfo{};
+        bool dropped = false;
+        bool monotonic = false;
+        handler_memory memory;
     };
 
+    typedef std::pair<dev_t,ino_t> key_type;
+    typedef device_table<key_type, joystick_type, s_devices> joystick_table;
+    typedef device_table<key_type, evdev_type, s_devices> evdev_table;
+
+    enum class source_type : std::uint8_t {
+        none,
+        gpio,
+        joydev,
+        evdev,
+    };
+
+    /**
+     * @brief An LED level, with the source and CLOCK_MONOTONIC time of the input that last changed it
+     */
     struct led_type{
-        const charlie_type charlie;
-        bool state = false;
+        std::uint8_t level = 0;
+        source_type source = source_type::none;
+        std::uint64_t stamp = 0;
     };
 
-    void enable(charlie_type charlie);
+    typedef std::array<led_type, 20> frame_type;
+
+    static led_map load_map(const Arguments & arguments);
+
+    void light(frame_type & leds, led_map::mask_type mask, std::uint8_t level, source_type source, std::uint64_t stamp) const;
+
+    void enable(const struct gpio_v2_line_config & config);
     void disable();
 
-    void async_read_inotify_events(
-        const std::shared_ptr<asio::streambuf> & buffer
-    );
+    void async_read_inotify_events();
 
     void handle_inotify_events(
-        const std::shared_ptr<asio::streambuf> & buffer,
         const asio::error_code & error,
         const inotify_event_results<asio::mutable_buffers_1> & results
     );
 
+    template<typename BufferSequence>
+    void process_inotify_events(
+        const inotify_event_results<BufferSequence> & events
+    );
+
     void async_read_joystick_events(
-        const std::shared_ptr<joystick_type> & joystick,
-        const std::shared_ptr<asio::streambuf> & buffer
+        device_handle handle,
+        joystick_type & joystick
     );
 
     void handle_joystick_events(
-        const std::shared_ptr<joystick_type> & joystick,
-        const std::shared_ptr<asio::streambuf> & buffer,
+        device_handle handle,
         const asio::error_code & error,
         const joystick_event_results<asio::mutable_buffers_1> & results
     );
 
+    void process_joystick_events(
+        device_handle handle,
+        joystick_type & joystick,
+        const joystick_event_results<asio::mutable_buffers_1> & results
+    );
+
+    void async_read_evdev_events(
+        device_handle handle,
+        evdev_type & evdev
+    );
+
+    void handle_evdev_events(
+        device_handle handle,
+        const asio::error_code & error,
+        const evdev_event_results<asio::mutable_buffers_1> & results
+    );
+
+    void process_evdev_events(
+        device_handle handle,
+        evdev_type & evdev,
+        const evdev_event_results<asio::mutable_buffers_1> & results
+    );
+
+    void synchronize(evdev_type & evdev);
+    void publish(device_handle handle, joystick_event_coalescer & events, source_type source);
+
     void async_read_gpio_line_events(
-        gpio_line_descriptor & line,
-        const std::shared_ptr<asio::streambuf> & buffer
+        gpio_line_descriptor & line
     );
 
     void handle_read_gpio_line_events(
         gpio_line_descriptor & line,
-        const std::shared_ptr<asio::streambuf> & buffer,
         const asio::error_code & error,
         const gpio_line_event_results<asio::mutable_buffers_1> & results
     );
 
+    void process_gpio_line_events(
+        const gpio_line_event_results<asio::mutable_buffers_1> & results
+    );
+
+    void process_gpio_line_event(const struct gpio_v2_line_event & event);
+
+    void async_wait_debounce();
+
+    template<typename Results>
+    void capture(capture_format::kind_type kind, std::uint32_t device, const Results & results);
+    void capture(capture_format::kind_type kind, std::uint32_t device, const void * data, std::size_t size);
+
+    void async_replay();
+
+    /**
+     * @brief Process one record on the strand its state belongs to, returning false if the replay continues from there
+     */
+    bool replay(const capture_reader::entry_type & entry);
+
+#if defined(TRAFFIC_COUNT_ALLOCATIONS)
+    /**
+     * @brief Run a handler on every io thread at once so each sets up its per-thread state, then continue the replay
+     */
+    void warm_threads();
+#endif
+
+    void async_wait_report();
+
     void resync();
     void insert(std::string_view name);
     void remove(std::string_view name);
+    std::optional<device_handle> insert_joystick(const key_type & key, std::string_view name, int fd);
+    std::optional<device_handle> insert_evdev(const key_type & key, std::string_view name, int fd);
+    template<typename Table>
+    void close(Table & table, device_handle handle);
+    template<typename Table>
+    void finish(Table & table, device_handle handle, typename Table::value_type & device);
+    const key_type * key(device_handle handle) const;
+    template<typename Descriptor>
+    void attach(Descriptor & descriptor, std::string_view name);
 
-    void update();
+    void async_update();
+    void update(const asio::error_code & error);
+    void scan(std::optional<unsigned> cpu, std::optional<int> priority);
+    void plan(const frame_type & leds);
+    void step();
+    void trace();
     void pwm();
 
     void setBrightness();
     void resetBrightness();
 
     asio::io_context & m_context;
+    event_logger m_logger;
+    strand_type m_registry;
+    strand_type m_gpio;
+    asio::signal_set m_signals;
     inotify_descriptor m_inotify;
+    handler_memory m_inotify_memory;
+    alignas(struct inotify_event) std::array<char, (sizeof(struct inotify_event) + NAME_MAX + 1) * s_inotify_batch> m_inotify_buffer;
+
+    const Arguments::input_type m_input_type;
+    const led_map m_map;
+    joystick_table m_joysticks;
+    evdev_table m_evdevs;
+    // Read buffers of the table slots, kept apart from the tables so only they are registered with io_uring
+    alignas(struct js_event) std::array<std::array<char, sizeof(struct js_event) * s_joystick_batch>, s_devices> m_joystick_buffers;
+    alignas(struct input_event) std::array<std::array<char, sizeof(struct input_event) * s_evdev_batch>, s_devices> m_evdev_buffers;
+    std::unordered_map<std::string, device_handle> m_devices;
 
-    std::unordered_map<decltype(joystick_type::key), std::shared_ptr<joystick_type>> m_joysticks;
+    capture_writer m_recorder;
+    capture_reader m_replayer;
+    const Arguments::pace_type m_replay_pace;
+    asio::steady_timer m_replay_timer;
+    std::unordered_map<std::uint32_t, device_handle> m_replayed;
+    std::uint64_t m_replay_origin = 0;
+    std::uint64_t m_replay_records = 0;
+    scan_scheduler::time_point m_replay_start;
+    handler_memory m_replay_memory;
+    bool m_replay_warm = false;
+    bool m_closing = false;
+    const unsigned m_threads;
+    std::atomic<unsigned> m_warming{0};
 
     gpio_chip_descriptor m_chip;
     gpio_line_descriptor m_input;
     gpio_line_descriptor m_output;
+    gpio_line_cache m_lines;
+    gpio_line_debouncer m_debouncer;
+    asio::steady_timer m_debounce_timer;
+    handler_memory m_debounce_memory;
+    bool m_debouncing = false;
+    gpio_line_sequence_tracker m_sequence;
+    handler_memory m_gpio_memory;
+    alignas(struct gpio_v2_line_event) std::array<char, sizeof(struct gpio_v2_line_event) * s_gpio_batch> m_gpio_buffer;
+    // Destroyed before the buffers the kernel reads into and the handler memory its pending reads were allocated from
+    io_ring m_ring;
     //gpio_line_descriptor m_pwm;
 
     //std::pair<std::chrono::microseconds, std::chrono::microseconds> m_mark;
 
-    std::array<led_type, 20> m_leds;
+    frame_buffer<frame_type> m_leds;
+    const frame_type * m_frame = nullptr;
+
+    const Arguments::scan_type m_scan;
+    const std::size_t m_steps;
+    scan_scheduler m_scheduler;
+    handler_memory m_scan_memory;
+    std::array<std::array<const struct gpio_v2_line_config *, 20>, 8> m_plan{};
+    // Bit i of a plane's mask is set when LED i is lit in that plane
+    std::array<std::uint32_t, 8> m_lit{};
+    std::uint32_t m_dark = 0;
+    std::size_t m_planes = 1;
+    std::size_t m_plane = 0;
+    std::size_t m_slot = 0;
+    scan_scheduler::duration m_span = scan_scheduler::duration::zero();
+    scan_scheduler::time_point m_frame_start;
+    concurrent_histogram m_frame_time;
+    concurrent_histogram m_step_time;
+    std::array<std::uint64_t, 20> m_traced{};
+    std::array<concurrent_histogram, 4> m_latency;
+
+    std::atomic<bool> m_scanning{false};
+    std::thread m_scanner;
 };
 
 #endif // APPLICATION_HPP
@@ -7,9 +7,47 @@
 
 struct Arguments {
     Arguments() = delete;
+    enum class scan_type {
+        led,
+        row,
+    };
+    enum class input_type {
+        joydev,
+        evdev,
+    };
+    enum class level_type {
+        none,
+        info,
+        event,
+    };
+    enum class pace_type {
+        realtime,
+        fast,
+    };
+
     Arguments(std::string_view name, const std::vector<std::string_view> & args);
 
+    /**
+     * @brief Return how many io threads to run, resolving 0 to one per core
+     */
+    unsigned io_threads() const;
+
     std::string_view name;
+    unsigned rate = 2000;
+    unsigned threads = 0;
+    bool io_uring = false;
+    scan_type scan = scan_type::led;
+    bool scan_thread = false;
+    std::optional<unsigned> scan_cpu;
+    std::optional<int> scan_priority;
+    input_type input = input_type::joydev;
+    unsigned debounce = 5000;
+    unsigned gpio_events = 64;
+    level_type log_level = level_type::event;
+    std::optional<std::string_view> record;
+    std::optional<std::string_view> replay;
+    pace_type replay_pace = pace_type::realtime;
+    std::optional<std::string_view> map;
 
 private:
     void help();
@@ -0,0 +1,301 @@
+#ifndef CAPTURE_FILE_HPP
+#define CAPTURE_FILE_HPP
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+} // extern "C"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <asio/error.hpp>
+#include <asio/system_error.hpp>
+
+/**
+ * @brief Layout of a capture file: a header, then records of raw descriptor reads
+ *
+ * Every record holds the bytes of one read exactly as the descriptor
+ * delivered them, prefixed with the CLOCK_MONOTONIC time of the read and the
+ * kind and device it came from.  Records start on 8 byte boundaries.
+ */
+struct capture_format {
+    enum class kind_type : std::uint32_t {
+        joystick,
+        evdev,
+        evdev_device,
+        gpio,
+        // Written by earlier versions only, and skipped on replay
+        inotify,
+    };
+
+    struct header_type {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t reserved;
+    };
+
+    struct record_type {
+        std::uint64_t stamp;
+        kind_type kind;
+        std::uint32_t device;
+        std::uint32_t size;
+        std::uint32_t reserved;
+    };
+
+    static constexpr char s_magic[8] = {'T', 'R', 'A', 'F', 'C', 'A', 'P', '\0'};
+    static constexpr std::uint32_t s_version = 1;
+
+    static constexpr std::size_t align(std::size_t size) {
+        return (size + 7) & ~std::size_t(7);
+    }
+};
+
+/**
+ * @brief Appends records to a capture file through a growing shared mapping
+ *
+ * Appends from any thread are serialized.  The file is grown in whole
+ * chunks as the mapping fills, and truncated to the records written on close.
+ */
+class capture_writer {
+public:
+    typedef capture_format::kind_type kind_type;
+
+    capture_writer() = default;
+    capture_writer(const capture_writer &) = delete;
+    capture_writer(capture_writer &&) = delete;
+    capture_writer & operator=(const capture_writer &) = delete;
+    capture_writer & operator=(capture_writer &&) = delete;
+    ~capture_writer() {
+        close();
+    }
+
+    void open(const std::string & path) {
+        asio::error_code ec;
+        open(path, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void open(const std::string & path, asio::error_code & ec) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (m_fd == -1) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            return;
+        }
+        capture_format::header_type header;
+        std::memcpy(header.magic, capture_format::s_magic, sizeof(header.magic));
+        header.version = capture_format::s_version;
+        header.reserved = 0;
+        write(&header, sizeof(header), ec);
+    }
+
+    bool is_open() const {
+        return m_fd != -1;
+    }
+
+    void append(kind_type kind, std::uint32_t device, std::uint64_t stamp, const void * data, std::size_t size) {
+        asio::error_code ec;
+        append(kind, device, stamp, data, size, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void append(kind_type kind, std::uint32_t device, std::uint64_t stamp, const void * data, std::size_t size, asio::error_code & ec) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        capture_format::record_type record;
+        record.stamp = stamp;
+        record.kind = kind;
+        record.device = device;
+        record.size = size;
+        record.reserved = 0;
+        write(&record, sizeof(record), ec);
+        if (!ec) {
+            write(data, size, ec);
+        }
+    }
+
+    void close() {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_data) {
+            ::munmap(m_data, m_capacity);
+            m_data = nullptr;
+        }
+        if (m_fd != -1) {
+            while (::ftruncate(m_fd, m_size) == -1 && errno == EINTR) {}
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_capacity = 0;
+        m_size = 0;
+    }
+
+private:
+    static constexpr std::size_t s_chunk = std::size_t(1) << 20;
+
+    void write(const void * data, std::size_t size, asio::error_code & ec) {
+        const std::size_t end = m_size + capture_format::align(size);
+        if (m_fd == -1) {
+            ec = asio::error::bad_descriptor;
+            return;
+        }
+        if (end > m_capacity) {
+            const std::size_t capacity = (end + s_chunk - 1) / s_chunk * s_chunk;
+            if (::ftruncate(m_fd, capacity) == -1) {
+                ec = asio::error_code(errno, asio::error::system_category);
+                return;
+            }
+            void * const mapping = m_data ?
+                ::mremap(m_data, m_capacity, capacity, MREMAP_MAYMOVE) :
+                ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+            if (mapping == MAP_FAILED) {
+                ec = asio::error_code(errno, asio::error::system_category);
+                return;
+            }
+            m_data = static_cast<char *>(mapping);
+            m_capacity = capacity;
+        }
+        std::memcpy(m_data + m_size, data, size);
+        std::memset(m_data + m_size + size, 0, end - m_size - size);
+        m_size = end;
+        ec = asio::error_code();
+    }
+
+    std::mutex m_mutex;
+    int m_fd = -1;
+    char * m_data = nullptr;
+    std::size_t m_capacity = 0;
+    std::size_t m_size = 0;
+};
+
+/**
+ * @brief Walks the records of a capture file mapped privately into memory
+ *
+ * The mapping is writable but private, so record data can be handed to the
+ * parsers as mutable buffers without copying and without touching the file.
+ */
+class capture_reader {
+public:
+    typedef capture_format::kind_type kind_type;
+
+    struct entry_type {
+        std::uint64_t stamp;
+        kind_type kind;
+        std::uint32_t device;
+        char * data;
+        std::size_t size;
+    };
+
+    capture_reader() = default;
+    capture_reader(const capture_reader &) = delete;
+    capture_reader(capture_reader &&) = delete;
+    capture_reader & operator=(const capture_reader &) = delete;
+    capture_reader & operator=(capture_reader &&) = delete;
+    ~capture_reader() {
+        close();
+    }
+
+    void open(const std::string & path) {
+        asio::error_code ec;
+        open(path, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void open(const std::string & path, asio::error_code & ec) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            return;
+        }
+        struct stat stat;
+        if (::fstat(fd, &stat) == -1) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            ::close(fd);
+            return;
+        }
+        const std::size_t size = stat.st_size;
+        if (size < sizeof(capture_format::header_type)) {
+            ec = asio::error::invalid_argument;
+            ::close(fd);
+            return;
+        }
+        void * const mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            return;
+        }
+        const capture_format::header_type & header = *static_cast<const capture_format::header_type *>(mapping);
+        if (
+            std::memcmp(header.magic, capture_format::s_magic, sizeof(header.magic)) != 0 ||
+            header.version != capture_format::s_version
+        ) {
+            ::munmap(mapping, size);
+            ec = asio::error::invalid_argument;
+            return;
+        }
+        m_data = static_cast<char *>(mapping);
+        m_size = size;
+        m_offset = sizeof(capture_format::header_type);
+        ec = asio::error_code();
+    }
+
+    bool is_open() const {
+        return m_data != nullptr;
+    }
+
+    /**
+     * @brief Return the next whole record, or std::nullopt at the end or at a truncated record
+     */
+    std::optional<entry_type> next() {
+        if (m_size - m_offset < sizeof(capture_format::record_type)) {
+            return std::nullopt;
+        }
+        capture_format::record_type record;
+        std::memcpy(&record, m_data + m_offset, sizeof(record));
+        const std::size_t begin = m_offset + sizeof(record);
+        if (m_size - begin < record.size) {
+            return std::nullopt;
+        }
+        m_offset = std::min(m_size, begin + capture_format::align(record.size));
+        return entry_type{record.stamp, record.kind, record.device, m_data + begin, record.size};
+    }
+
+    /**
+     * @brief Start over from the first record
+     */
+    void rewind() {
+        if (m_data) {
+            m_offset = sizeof(capture_format::header_type);
+        }
+    }
+
+    void close() {
+        if (m_data) {
+            ::munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+        m_size = 0;
+        m_offset = 0;
+    }
+
+private:
+    char * m_data = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_offset = 0;
+};
+
+#endif // CAPTURE_FILE_HPP
@@ -0,0 +1,92 @@
+#ifndef CHARLIE_TABLE_HPP
+#define CHARLIE_TABLE_HPP
+
+extern "C" {
+#include <linux/gpio.h>
+} // extern "C"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+typedef std::pair<std::size_t, std::size_t> charlie_type;
+
+/**
+ * @brief Build the line config that drives one anode high and a set of cathodes low
+ *
+ * Every other line is left as a high impedance input.  Direction and output
+ * values travel in the same config, so a single GPIO_V2_LINE_SET_CONFIG_IOCTL
+ * moves the lines from any previous step straight to this one.
+ */
+constexpr struct gpio_v2_line_config make_charlie_config(std::size_t anode, std::uint64_t cathodes) {
+    const std::uint64_t outputs = (std::uint64_t(1) << anode) | cathodes;
+
+    struct gpio_v2_line_config config{};
+    config.flags = GPIO_V2_LINE_FLAG_INPUT;
+    if (cathodes) {
+        config.num_attrs = 2;
+        config.attrs[0].mask = outputs;
+        config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+        config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+        config.attrs[1].mask = outputs;
+        config.attrs[1].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+        config.attrs[1].attr.values = std::uint64_t(1) << anode;
+    }
+    return config;
+}
+
+/**
+ * @brief Build the line config that releases every line to a high impedance input
+ */
+constexpr struct gpio_v2_line_config make_charlie_idle_config() {
+    return make_charlie_config(0, 0);
+}
+
+namespace detail {
+
+template<std::size_t N, std::size_t... I>
+constexpr std::array<struct gpio_v2_line_config, N> make_charlie_slot_table(
+    const std::array<charlie_type, N> & charlies,
+    std::index_sequence<I...>
+) {
+    return {{make_charlie_config(charlies[I].first, std::uint64_t(1) << charlies[I].second)...}};
+}
+
+template<std::size_t Lines, std::size_t... I>
+constexpr std::array<struct gpio_v2_line_config, (1 << Lines)> make_charlie_row(
+    std::size_t anode,
+    std::index_sequence<I...>
+) {
+    return {{make_charlie_config(anode, I & ~(std::uint64_t(1) << anode))...}};
+}
+
+template<std::size_t Lines, std::size_t... I>
+constexpr std::array<std::array<struct gpio_v2_line_config, (1 << Lines)>, Lines> make_charlie_row_table(
+    std::index_sequence<I...>
+) {
+    return {{make_charlie_row<Lines>(I, std::make_index_sequence<(1 << Lines)>())...}};
+}
+
+} // namespace detail
+
+/**
+ * @brief Build one line config per LED, each lighting that LED alone
+ */
+template<std::size_t N>
+constexpr std::array<struct gpio_v2_line_config, N> make_charlie_slot_table(const std::array<charlie_type, N> & charlies) {
+    return detail::make_charlie_slot_table(charlies, std::make_index_sequence<N>());
+}
+
+/**
+ * @brief Build one line config per anode and cathode mask, indexed as [anode][cathodes]
+ *
+ * Each config drives its anode high and sinks every cathode in the mask at
+ * once, lighting up to Lines - 1 LEDs in a single step.
+ */
+template<std::size_t Lines>
+constexpr std::array<std::array<struct gpio_v2_line_config, (1 << Lines)>, Lines> make_charlie_row_table() {
+    return detail::make_charlie_row_table<Lines>(std::make_index_sequence<Lines>());
+}
+
+#endif // CHARLIE_TABLE_HPP
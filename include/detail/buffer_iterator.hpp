@@ -15,6 +15,7 @@ public:
     typedef typename Parser::pointer pointer;
     typedef typename Parser::reference reference;
     typedef typename Parser::iterator_category iterator_category;
+    typedef typename Parser::state_type state_type;
 
     buffer_iterator() = default;
     template<
@@ -31,6 +32,10 @@ public:
     buffer_iterator & operator=(buffer_iterator &&) = default;
     ~buffer_iterator() = default;
 
+    const state_type & base() const {
+        return m_parser.state();
+    }
+
     reference operator*() const {
         return m_parser.dereference();
     }
@@ -39,7 +44,7 @@ public:
         return &operator*();
     }
 
-    reference operator[](difference_type difference) {
+    reference operator[](difference_type difference) const {
         return buffer_iterator(*this).operator+=(difference).operator*();
     }
 
@@ -69,7 +74,7 @@ public:
     }
 
     buffer_iterator & operator-=(difference_type difference) {
-        m_parser.advance(difference);
+        m_parser.advance(-difference);
         return *this;
     }
 
@@ -83,7 +88,7 @@ public:
         return buffer_iterator(iterator) -= difference;
     }
     friend difference_type operator-(const buffer_iterator & lhs, const buffer_iterator & rhs) {
-        return lhs.m_event - rhs.m_event;
+        return lhs.m_parser.difference(rhs.m_parser.state());
     }
 
     friend bool operator==(const buffer_iterator & lhs, const buffer_iterator & rhs) {
@@ -2,17 +2,31 @@
 #define BUFFER_RESULTS_HPP
 
 #include <cstddef>
+#include <iterator>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
 namespace detail {
 
+/**
+ * @brief Range of the records parsed from a read
+ *
+ * Over a single contiguous buffer of fixed-size records the range is also a
+ * span: data() points at the records themselves and size() counts them.
+ */
 template<typename Iterator>
 class buffer_results {
 public:
     typedef typename Iterator::value_type value_type;
     typedef std::size_t size_type;
 
+    static constexpr bool s_random_access = std::is_same_v<
+        typename Iterator::iterator_category,
+        std::random_access_iterator_tag
+    >;
+    static constexpr bool s_contiguous = s_random_access && std::is_pointer_v<typename Iterator::state_type>;
+
     typedef value_type & reference;
     typedef const value_type & const_reference;
 
@@ -50,6 +64,21 @@ public:
         return m_value.first == m_value.second;
     }
 
+    template<bool RandomAccess = s_random_access, typename = std::enable_if_t<RandomAccess>>
+    size_type size() const {
+        return m_value.second - m_value.first;
+    }
+
+    template<bool Contiguous = s_contiguous, typename = std::enable_if_t<Contiguous>>
+    const value_type * data() const {
+        return reinterpret_cast<const value_type *>(m_value.first.base());
+    }
+
+    template<bool Contiguous = s_contiguous, typename = std::enable_if_t<Contiguous>>
+    const_reference operator[](size_type index) const {
+        return data()[index];
+    }
+
     size_type max_size() const {
         return std::numeric_limits<size_type>::max() / sizeof(value_type);
     }
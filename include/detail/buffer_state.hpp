@@ -0,0 +1,73 @@
+#ifndef BUFFER_STATE_HPP
+#define BUFFER_STATE_HPP
+
+#include <cstddef>
+#include <type_traits>
+
+#include <asio/buffer.hpp>
+#include <asio/buffers_iterator.hpp>
+
+namespace detail {
+
+/**
+ * @brief Where a parser stands in a buffer sequence
+ *
+ * A byte iterator over the whole sequence in general, and a plain pointer
+ * when the sequence is a single contiguous buffer, so parsers over the
+ * buffers every read uses step through memory directly.
+ */
+template<typename BufferSequence, typename ByteType>
+struct buffer_state {
+    typedef asio::buffers_iterator<BufferSequence, ByteType> type;
+
+    static type begin(const BufferSequence & buffers) {
+        return type::begin(buffers);
+    }
+
+    static type end(const BufferSequence & buffers) {
+        return type::end(buffers);
+    }
+};
+
+template<typename Buffer, typename ByteType>
+struct contiguous_buffer_state {
+    typedef std::conditional_t<
+        std::is_convertible_v<Buffer, asio::mutable_buffer>,
+        ByteType *,
+        const ByteType *
+    > type;
+
+    static type begin(const Buffer & buffer) {
+        return static_cast<type>(buffer.data());
+    }
+
+    static type end(const Buffer & buffer) {
+        return begin(buffer) + buffer.size();
+    }
+};
+
+template<typename ByteType>
+struct buffer_state<asio::mutable_buffer, ByteType> : contiguous_buffer_state<asio::mutable_buffer, ByteType> {};
+
+template<typename ByteType>
+struct buffer_state<asio::const_buffer, ByteType> : contiguous_buffer_state<asio::const_buffer, ByteType> {};
+
+template<typename ByteType>
+struct buffer_state<asio::mutable_buffers_1, ByteType> : contiguous_buffer_state<asio::mutable_buffers_1, ByteType> {};
+
+template<typename ByteType>
+struct buffer_state<asio::const_buffers_1, ByteType> : contiguous_buffer_state<asio::const_buffers_1, ByteType> {};
+
+template<typename ByteType = char, typename BufferSequence>
+typename buffer_state<BufferSequence, ByteType>::type buffers_begin(const BufferSequence & buffers) {
+    return buffer_state<BufferSequence, ByteType>::begin(buffers);
+}
+
+template<typename ByteType = char, typename BufferSequence>
+typename buffer_state<BufferSequence, ByteType>::type buffers_end(const BufferSequence & buffers) {
+    return buffer_state<BufferSequence, ByteType>::end(buffers);
+}
+
+} // namespace detail
+
+#endif // BUFFER_STATE_HPP
@@ -0,0 +1,98 @@
+#ifndef READ_HANDLER_HPP
+#define READ_HANDLER_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <asio/associated_allocator.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/error.hpp>
+
+#include "buffer_state.hpp"
+
+namespace detail {
+
+/**
+ * @brief Completion handler turning a byte count into a parsed results range
+ *
+ * The associated executor and allocator of the wrapped handler are
+ * forwarded, so a handler bound to a strand still completes on that strand.
+ */
+template<typename Results, typename MutableBufferSequence, typename Handler>
+class read_handler {
+public:
+    typedef Handler handler_type;
+
+    read_handler() = delete;
+    template<typename DeducedHandler>
+    read_handler(const MutableBufferSequence & buffers, DeducedHandler && handler) :
+        m_buffers(buffers),
+        m_handler(std::forward<DeducedHandler>(handler))
+    {}
+    read_handler(const read_handler &) = default;
+    read_handler(read_handler &&) = default;
+    read_handler & operator=(const read_handler &) = default;
+    read_handler & operator=(read_handler &&) = default;
+    ~read_handler() = default;
+
+    void operator()(const asio::error_code & error, std::size_t bytes_transferred) {
+        m_handler(
+            error,
+            Results(
+                detail::buffers_begin(m_buffers),
+                error ? detail::buffers_begin(m_buffers) : detail::buffers_begin(m_buffers) + bytes_transferred
+            )
+        );
+    }
+
+    const handler_type & handler() const {
+        return m_handler;
+    }
+
+private:
+    MutableBufferSequence m_buffers;
+    handler_type m_handler;
+};
+
+template<typename Results, typename MutableBufferSequence, typename Handler>
+read_handler<Results, MutableBufferSequence, std::decay_t<Handler>> make_read_handler(
+    const MutableBufferSequence & buffers,
+    Handler && handler
+) {
+    return read_handler<Results, MutableBufferSequence, std::decay_t<Handler>>(buffers, std::forward<Handler>(handler));
+}
+
+} // namespace detail
+
+namespace asio {
+
+template<typename Results, typename MutableBufferSequence, typename Handler, typename Executor>
+struct associated_executor<::detail::read_handler<Results, MutableBufferSequence, Handler>, Executor> {
+    typedef typename associated_executor<Handler, Executor>::type type;
+
+    static type get(const ::detail::read_handler<Results, MutableBufferSequence, Handler> & handler) noexcept {
+        return associated_executor<Handler, Executor>::get(handler.handler());
+    }
+
+    static type get(const ::detail::read_handler<Results, MutableBufferSequence, Handler> & handler, const Executor & executor) noexcept {
+        return associated_executor<Handler, Executor>::get(handler.handler(), executor);
+    }
+};
+
+template<typename Results, typename MutableBufferSequence, typename Handler, typename Allocator>
+struct associated_allocator<::detail::read_handler<Results, MutableBufferSequence, Handler>, Allocator> {
+    typedef typename associated_allocator<Handler, Allocator>::type type;
+
+    static type get(const ::detail::read_handler<Results, MutableBufferSequence, Handler> & handler) noexcept {
+        return associated_allocator<Handler, Allocator>::get(handler.handler());
+    }
+
+    static type get(const ::detail::read_handler<Results, MutableBufferSequence, Handler> & handler, const Allocator & allocator) noexcept {
+        return associated_allocator<Handler, Allocator>::get(handler.handler(), allocator);
+    }
+};
+
+} // namespace asio
+
+#endif // READ_HANDLER_HPP
@@ -0,0 +1,147 @@
+#ifndef DEVICE_TABLE_HPP
+#define DEVICE_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+
+struct device_handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    friend bool operator==(const device_handle & lhs, const device_handle & rhs) {
+        return lhs.index == rhs.index && lhs.generation == rhs.generation;
+    }
+    friend bool operator!=(const device_handle & lhs, const device_handle & rhs) {
+        return !(lhs == rhs);
+    }
+};
+
+/**
+ * @brief Fixed-capacity open-addressing table with stable slots and generation-checked handles
+ *
+ * Entries are constructed in place and never move, so a handle (slot index
+ * plus generation) stays cheap to copy into completion handlers.  Erasing an
+ * entry bumps its slot generation, so handles to it stop resolving even
+ * after the slot is reused.  Keys are placed by linear probing on Hash.
+ */
+template<typename Key, typename Value, std::size_t Capacity, typename Hash = std::hash<Key>>
+class device_table {
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+    typedef Key key_type;
+    typedef Value value_type;
+    typedef std::size_t size_type;
+    typedef device_handle handle_type;
+
+    device_table() = default;
+    device_table(const device_table &) = delete;
+    device_table(device_table &&) = delete;
+    device_table & operator=(const device_table &) = delete;
+    device_table & operator=(device_table &&) = delete;
+    ~device_table() = default;
+
+    /**
+     * @brief Construct a value for a new key, or return std::nullopt if the key exists or the table is full
+     */
+    template<typename... Args>
+    std::optional<handle_type> emplace(const key_type & key, Args &&... args) {
+        std::optional<std::size_t> free;
+        for (std::size_t probe = 0, index = Hash()(key) & s_mask; probe != Capacity; ++probe, index = (index + 1) & s_mask) {
+            slot_type & slot = m_slots[index];
+            if (slot.value) {
+                if (slot.key == key) {
+                    return std::nullopt;
+                }
+            } else {
+                if (!free) {
+                    free = index;
+                }
+                if (!slot.tombstone) {
+                    break;
+                }
+            }
+        }
+        if (!free) {
+            return std::nullopt;
+        }
+        slot_type & slot = m_slots[*free];
+        slot.key = key;
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.tombstone = false;
+        ++m_size;
+        return handle_type{static_cast<std::uint32_t>(*free), slot.generation};
+    }
+
+    std::optional<handle_type> find(const key_type & key) const {
+        for (std::size_t probe = 0, index = Hash()(key) & s_mask; probe != Capacity; ++probe, index = (index + 1) & s_mask) {
+            const slot_type & slot = m_slots[index];
+            if (slot.value) {
+                if (slot.key == key) {
+                    return handle_type{static_cast<std::uint32_t>(index), slot.generation};
+                }
+            } else if (!slot.tombstone) {
+                break;
+            }
+        }
+        return std::nullopt;
+    }
+
+    value_type * get(handle_type handle) {
+        slot_type & slot = m_slots[handle.index & s_mask];
+        return slot.value && slot.generation == handle.generation ? &*slot.value : nullptr;
+    }
+
+    const value_type * get(handle_type handle) const {
+        const slot_type & slot = m_slots[handle.index & s_mask];
+        return slot.value && slot.generation == handle.generation ? &*slot.value : nullptr;
+    }
+
+    const key_type * key(handle_type handle) const {
+        const slot_type & slot = m_slots[handle.index & s_mask];
+        return slot.value && slot.generation == handle.generation ? &slot.key : nullptr;
+    }
+
+    bool erase(handle_type handle) {
+        slot_type & slot = m_slots[handle.index & s_mask];
+        if (!slot.value || slot.generation != handle.generation) {
+            return false;
+        }
+        slot.value.reset();
+        slot.tombstone = true;
+        ++slot.generation;
+        --m_size;
+        return true;
+    }
+
+    size_type size() const {
+        return m_size;
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    static constexpr size_type capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr std::size_t s_mask = Capacity - 1;
+
+    struct slot_type {
+        key_type key{};
+        std::optional<value_type> value;
+        std::uint32_t generation = 0;
+        bool tombstone = false;
+    };
+
+    std::array<slot_type, Capacity> m_slots;
+    size_type m_size = 0;
+};
+
+#endif // DEVICE_TABLE_HPP
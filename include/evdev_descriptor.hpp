@@ -0,0 +1,350 @@
+#ifndef EVDEV_DESCRIPTOR_HPP
+#define EVDEV_DESCRIPTOR_HPP
+
+extern "C" {
+#include <linux/input.h>
+#include <sys/ioctl.h>
+} // extern "C"
+
+#include <array>
+#include <climits>
+#include <ctime>
+
+#include <asio/posix/stream_descriptor.hpp>
+
+#include "detail/read_handler.hpp"
+#include "evdev_event_results.hpp"
+#include "io_ring.hpp"
+
+class evdev_descriptor {
+public:
+    typedef std::array<char, 255> name_type;
+    typedef int version_type;
+    typedef struct input_id id_type;
+    typedef struct input_absinfo absinfo_type;
+    typedef std::array<unsigned long, (KEY_CNT + sizeof(unsigned long) * CHAR_BIT - 1) / (sizeof(unsigned long) * CHAR_BIT)> bits_type;
+
+    using bytes_readable = asio::posix::stream_descriptor::bytes_readable;
+    using executor_type = asio::posix::stream_descriptor::executor_type;
+    using lowest_layer_type = asio::posix::stream_descriptor::lowest_layer_type;
+    using native_handle_type = asio::posix::stream_descriptor::native_handle_type;
+    using wait_type = asio::posix::stream_descriptor::wait_type;
+
+    evdev_descriptor() = delete;
+    evdev_descriptor(asio::io_context & io_context) :
+        m_stream(io_context)
+    {}
+    evdev_descriptor(asio::io_context & io_context, const native_handle_type & native_descriptor) :
+        m_stream(io_context, native_descriptor)
+    {}
+    evdev_descriptor(const evdev_descriptor &) = delete;
+    evdev_descriptor(evdev_descriptor &&) = default;
+    evdev_descriptor & operator=(const evdev_descriptor &) = delete;
+    evdev_descriptor & operator=(evdev_descriptor &&) = default;
+    ~evdev_descriptor() = default;
+
+    absinfo_type absinfo(unsigned axis) {
+        asio::error_code ec;
+        const absinfo_type absinfo = this->absinfo(axis, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return absinfo;
+    }
+
+    absinfo_type absinfo(unsigned axis, asio::error_code & ec) {
+        absinfo_type absinfo;
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGABS(axis), &absinfo) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return absinfo;
+    }
+
+    void assign(const native_handle_type & native_descriptor) {
+        m_stream.assign(native_descriptor);
+    }
+
+    void assign(const native_handle_type & native_descriptor, asio::error_code & ec) {
+        m_stream.assign(native_descriptor, ec);
+    }
+
+    template<typename MutableBufferSequence, typename EventHandler>
+    void async_read_events(const MutableBufferSequence & buffers, EventHandler && handler) {
+        auto read_handler = detail::make_read_handler<evdev_event_results<MutableBufferSequence>>(buffers, std::forward<EventHandler>(handler));
+        if (m_ring) {
+            m_ring->async_read_some(m_stream.native_handle(), buffers, std::move(read_handler));
+        } else {
+            m_stream.async_read_some(buffers, std::move(read_handler));
+        }
+    }
+
+    template<typename WaitHandler>
+    auto async_wait(wait_type w, WaitHandler && handler) {
+        return m_stream.async_wait(w, std::forward<WaitHandler>(handler));
+    }
+
+    /**
+     * @brief Read through ring from now on instead of through the io_context's reactor
+     *
+     * The descriptor is made non-blocking, so the kernel polls it instead of
+     * parking a worker thread in the driver for each read.
+     */
+    void attach(io_ring & ring) {
+        m_stream.native_non_blocking(true);
+        m_ring = &ring;
+    }
+
+    void attach(io_ring & ring, asio::error_code & ec) {
+        m_stream.native_non_blocking(true, ec);
+        if (!ec) {
+            m_ring = &ring;
+        }
+    }
+
+    /**
+     * @brief Request the codes supported for an event type, or the supported event types for type 0
+     */
+    bits_type bits(unsigned type) {
+        asio::error_code ec;
+        const bits_type bits = this->bits(type, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Request the codes supported for an event type, or the supported event types for type 0
+     */
+    bits_type bits(unsigned type, asio::error_code & ec) {
+        bits_type bits{};
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGBIT(type, sizeof(bits)), bits.data()) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return bits;
+    }
+
+    void cancel() {
+        cancel_ring();
+        return m_stream.cancel();
+    }
+
+    void cancel(asio::error_code & ec) {
+        cancel_ring();
+        m_stream.cancel(ec);
+    }
+
+    void close() {
+        cancel_ring();
+        return m_stream.close();
+    }
+
+    void close(asio::error_code & ec) {
+        cancel_ring();
+        m_stream.close(ec);
+    }
+
+    /**
+     * @brief Select the clock used to timestamp events, such as CLOCK_MONOTONIC
+     */
+    void clock(clockid_t clock) {
+        asio::error_code ec;
+        this->clock(clock, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    /**
+     * @brief Select the clock used to timestamp events, such as CLOCK_MONOTONIC
+     */
+    void clock(clockid_t clock, asio::error_code & ec) {
+        int id = clock;
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCSCLOCKID, &id) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+    }
+
+    executor_type get_executor() {
+        return m_stream.get_executor();
+    }
+
+    id_type id() {
+        asio::error_code ec;
+        const id_type id = this->id(ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return id;
+    }
+
+    id_type id(asio::error_code & ec) {
+        id_type id;
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGID, &id) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return id;
+    }
+
+    template<typename IoControlCommand>
+    void io_control(IoControlCommand & command) {
+        m_stream.io_control(command);
+    }
+
+    template<typename IoControlCommand>
+    void io_control(IoControlCommand & command, asio::error_code & ec) {
+        m_stream.io_control(command, ec);
+    }
+
+    bool is_open() const {
+        return m_stream.is_open();
+    }
+
+    /**
+     * @brief Request the current state of every key
+     */
+    bits_type key_state() {
+        asio::error_code ec;
+        const bits_type bits = this->key_state(ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Request the current state of every key
+     */
+    bits_type key_state(asio::error_code & ec) {
+        bits_type bits{};
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGKEY(sizeof(bits)), bits.data()) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return bits;
+    }
+
+    lowest_layer_type & lowest_layer() {
+        return m_stream.lowest_layer();
+    }
+
+    const lowest_layer_type & lowest_layer() const {
+        return m_stream.lowest_layer();
+    }
+
+    name_type name() {
+        asio::error_code ec;
+        const name_type name = this->name(ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return name;
+    }
+
+    name_type name(asio::error_code & ec) {
+        name_type name{};
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGNAME(name.size() - 1), name.data()) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return name;
+    }
+
+    native_handle_type native_handle() {
+        return m_stream.native_handle();
+    }
+
+    bool native_non_blocking() const {
+        return m_stream.native_non_blocking();
+    }
+
+    void native_non_blocking(bool mode) {
+        m_stream.native_non_blocking(mode);
+    }
+
+    void native_non_blocking(bool mode, asio::error_code & ec) {
+        m_stream.native_non_blocking(mode, ec);
+    }
+
+    bool non_blocking() const {
+        return m_stream.non_blocking();
+    }
+
+    void non_blocking(bool mode) {
+        m_stream.non_blocking(mode);
+    }
+
+    void non_blocking(bool mode, asio::error_code & ec) {
+        m_stream.non_blocking(mode, ec);
+    }
+
+    template<typename MutableBufferSequence>
+    evdev_event_results<MutableBufferSequence> read_events(const MutableBufferSequence & buffers) {
+        const std::size_t bytes_transferred = m_stream.read_some(buffers);
+        return evdev_event_results<MutableBufferSequence>(
+            detail::buffers_begin(buffers),
+            detail::buffers_begin(buffers) + bytes_transferred
+        );
+    }
+
+    template<typename MutableBufferSequence>
+    evdev_event_results<MutableBufferSequence> read_events(const MutableBufferSequence & buffers, asio::error_code & ec) {
+        const std::size_t bytes_transferred = m_stream.read_some(buffers, ec);
+        return evdev_event_results<MutableBufferSequence>(
+            detail::buffers_begin(buffers),
+            ec ? detail::buffers_begin(buffers) : detail::buffers_begin(buffers) + bytes_transferred
+        );
+    }
+
+    native_handle_type release() {
+        cancel_ring();
+        return m_stream.release();
+    }
+
+    version_type version() {
+        asio::error_code ec;
+        const version_type version = this->version(ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+        return version;
+    }
+
+    version_type version(asio::error_code & ec) {
+        version_type version;
+        ec = asio::error_code(
+            ::ioctl(m_stream.native_handle(), EVIOCGVERSION, &version) < 0 ? errno : 0,
+            asio::error::system_category
+        );
+        return version;
+    }
+
+    static bool test(const bits_type & bits, std::size_t bit) {
+        static constexpr std::size_t s_bits = sizeof(bits_type::value_type) * CHAR_BIT;
+        return bit / s_bits < bits.size() && (bits[bit / s_bits] >> (bit % s_bits)) & 1;
+    }
+
+    void wait(wait_type w) {
+        m_stream.wait(w);
+    }
+
+    void wait(wait_type w, asio::error_code & ec) {
+        m_stream.wait(w, ec);
+    }
+
+private:
+    void cancel_ring() {
+        if (m_ring && m_stream.is_open()) {
+            m_ring->cancel(m_stream.native_handle());
+        }
+    }
+
+    asio::posix::stream_descriptor m_stream;
+    io_ring * m_ring = nullptr;
+};
+
+#endif // EVDEV_DESCRIPTOR_HPP
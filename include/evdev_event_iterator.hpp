@@ -0,0 +1,13 @@
+#ifndef EVDEV_EVENT_ITERATOR_HPP
+#define EVDEV_EVENT_ITERATOR_HPP
+
+#include "detail/buffer_iterator.hpp"
+
+#include "evdev_event_parser.hpp"
+
+template<typename BufferSequence, typename ByteType = char>
+using evdev_event_iterator = detail::buffer_iterator<
+    evdev_event_parser<BufferSequence, ByteType>
+>;
+
+#endif // EVDEV_EVENT_ITERATOR_HPP
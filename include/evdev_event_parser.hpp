@@ -0,0 +1,62 @@
+#ifndef EVDEV_EVENT_PARSER_HPP
+#define EVDEV_EVENT_PARSER_HPP
+
+extern "C" {
+#include <linux/input.h>
+} // extern "C"
+
+#include "detail/buffer_state.hpp"
+
+template<typename BufferSequence, typename ByteType = char>
+struct evdev_event_parser {
+    using state_type = typename detail::buffer_state<BufferSequence, ByteType>::type;
+
+    using difference_type = std::ptrdiff_t;
+    using value_type = struct input_event;
+    using pointer = const value_type *;
+    using reference = const value_type &;
+    using iterator_category = std::random_access_iterator_tag;
+
+    evdev_event_parser(state_type state) : m_state(std::move(state)) {}
+
+    const state_type & state() const {
+        return m_state;
+    }
+    reference dereference() const {
+        return *reinterpret_cast<pointer>(&*m_state);
+    }
+    void increment() {
+        m_state += sizeof(value_type);
+    }
+    void decrement() {
+        m_state -= sizeof(value_type);
+    }
+    void advance(difference_type difference) {
+        m_state += sizeof(value_type) * difference;
+    }
+    difference_type difference(const state_type & rhs) const {
+        return (m_state - rhs) / sizeof(value_type);
+    }
+    friend bool operator==(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state == rhs.m_state;
+    }
+    friend bool operator!=(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state != rhs.m_state;
+    }
+    friend bool operator<(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state < rhs.m_state;
+    }
+    friend bool operator>(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state > rhs.m_state;
+    }
+    friend bool operator<=(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state <= rhs.m_state;
+    }
+    friend bool operator>=(const evdev_event_parser & lhs, const evdev_event_parser & rhs) {
+        return lhs.m_state >= rhs.m_state;
+    }
+private:
+    state_type m_state;
+};
+
+#endif // EVDEV_EVENT_PARSER_HPP
@@ -0,0 +1,13 @@
+#ifndef EVDEV_EVENT_RESULTS_HPP
+#define EVDEV_EVENT_RESULTS_HPP
+
+#include "detail/buffer_results.hpp"
+
+#include "evdev_event_iterator.hpp"
+
+template<typename BufferSequence, typename ByteType = char>
+using evdev_event_results = detail::buffer_results<
+    evdev_event_iterator<BufferSequence, ByteType>
+>;
+
+#endif // EVDEV_EVENT_RESULTS_HPP
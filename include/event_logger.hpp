@@ -0,0 +1,325 @@
+#ifndef EVENT_LOGGER_HPP
+#define EVENT_LOGGER_HPP
+
+extern "C" {
+#include <linux/gpio.h>
+#include <linux/joystick.h>
+#include <unistd.h>
+} // extern "C"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.hpp"
+
+/**
+ * @brief Logs input events as compact binary records, formatted and written off the calling thread
+ *
+ * Each logging thread gets its own wait-free ring on first use, so event
+ * handlers never share a lock or make a system call to log.  A drainer
+ * thread polls the rings, orders what it collected by time, formats it and
+ * writes the batch with one write(2).  Records that find their ring full are
+ * counted and dropped rather than stalling the handler.  Batches are bounded
+ * and their storage reserved up front, so once every logging thread has its
+ * ring, logging allocates nothing.
+ */
+class event_logger {
+public:
+    enum class level_type {
+        none,
+        info,
+        event,
+    };
+
+    typedef std::uint64_t count_type;
+
+    event_logger() = delete;
+    event_logger(level_type level, int fd = STDOUT_FILENO) :
+        m_level(level),
+        m_fd(fd),
+        m_id(s_next_id.fetch_add(1, std::memory_order_relaxed))
+    {
+        if (m_level != level_type::none) {
+            m_running = true;
+            m_drainer = std::thread([this](){
+                drain();
+            });
+        }
+    }
+    event_logger(const event_logger &) = delete;
+    event_logger(event_logger &&) = delete;
+    event_logger & operator=(const event_logger &) = delete;
+    event_logger & operator=(event_logger &&) = delete;
+    ~event_logger() {
+        if (m_drainer.joinable()) {
+            m_running = false;
+            m_drainer.join();
+        }
+        for (std::atomic<ring_type *> & ring : m_rings) {
+            delete ring.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool enabled(level_type level) const {
+        return level != level_type::none && level <= m_level;
+    }
+
+    /**
+     * @brief Claim the calling thread's ring now rather than on its first record
+     */
+    void claim() {
+        if (m_level != level_type::none) {
+            local();
+        }
+    }
+
+    void joystick(std::uint32_t device, const struct js_event & event) {
+        if (enabled(level_type::event)) {
+            record_type record = make_record(kind_type::joystick);
+            record.joystick.device = device;
+            record.joystick.event = event;
+            push(record);
+        }
+    }
+
+    void gpio(const struct gpio_v2_line_event & event) {
+        if (enabled(level_type::event)) {
+            record_type record = make_record(kind_type::gpio);
+            record.gpio = event;
+            push(record);
+        }
+    }
+
+    void added(std::uint32_t device, std::string_view name, std::int32_t version, unsigned axes, unsigned buttons) {
+        if (enabled(level_type::info)) {
+            record_type record = make_record(kind_type::added);
+            record.added.device = device;
+            record.added.version = version;
+            record.added.axes = axes;
+            record.added.buttons = buttons;
+            const std::size_t size = std::min(name.size(), sizeof(record.added.name) - 1);
+            std::memcpy(record.added.name, name.data(), size);
+            record.added.name[size] = '\0';
+            push(record);
+        }
+    }
+
+    void removed(std::uint32_t device) {
+        if (enabled(level_type::info)) {
+            record_type record = make_record(kind_type::removed);
+            record.removed.device = device;
+            push(record);
+        }
+    }
+
+    count_type dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    enum class kind_type : std::uint8_t {
+        joystick,
+        gpio,
+        added,
+        removed,
+    };
+
+    struct record_type {
+        kind_type kind;
+        // Position in the drained batch, so sorting keeps each ring's order without a stable sort
+        std::uint32_t order;
+        std::uint64_t stamp;
+        union {
+            struct {
+                std::uint32_t device;
+                struct js_event event;
+            } joystick;
+            struct gpio_v2_line_event gpio;
+            struct {
+                std::uint32_t device;
+                std::int32_t version;
+                std::uint16_t axes;
+                std::uint16_t buttons;
+                char name[64];
+            } added;
+            struct {
+                std::uint32_t device;
+            } removed;
+        };
+    };
+
+    typedef spsc_ring<record_type, 1024> ring_type;
+
+    static constexpr std::size_t s_rings = 64;
+    static constexpr std::size_t s_batch = 1024;
+    static constexpr std::size_t s_line = 160;
+    static constexpr std::chrono::milliseconds s_idle{10};
+    static inline std::atomic<std::uint64_t> s_next_id{0};
+
+    static record_type make_record(kind_type kind) {
+        record_type record;
+        record.kind = kind;
+        record.stamp = std::chrono::nanoseconds(std::chrono::steady_clock::now().time_since_epoch()).count();
+        return record;
+    }
+
+    void push(const record_type & record) {
+        ring_type * const ring = local();
+        if (!ring || !ring->push(record)) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Return the ring of the calling thread, claiming one on first use
+     */
+    ring_type * local() {
+        thread_local std::uint64_t owner = ~std::uint64_t(0);
+        thread_local ring_type * ring = nullptr;
+        if (owner != m_id) {
+            owner = m_id;
+            ring = nullptr;
+            std::unique_ptr<ring_type> created(new ring_type());
+            for (std::atomic<ring_type *> & slot : m_rings) {
+                ring_type * expected = nullptr;
+                if (slot.compare_exchange_strong(expected, created.get(), std::memory_order_acq_rel)) {
+                    ring = created.release();
+                    break;
+                }
+            }
+        }
+        return ring;
+    }
+
+    void drain() {
+        std::vector<record_type> records;
+        records.reserve(s_batch);
+        std::string text;
+        text.reserve(s_batch * s_line);
+        bool running = true;
+        bool full = false;
+        while (running || full) {
+            // Read the flag first, so the last sweeps see every record pushed before shutdown
+            running = m_running.load(std::memory_order_acquire);
+            records.clear();
+            for (std::atomic<ring_type *> & slot : m_rings) {
+                if (ring_type * const ring = slot.load(std::memory_order_acquire)) {
+                    record_type record;
+                    while (records.size() != s_batch && ring->pop(record)) {
+                        record.order = records.size();
+                        records.push_back(record);
+                    }
+                }
+            }
+            full = records.size() == s_batch;
+            if (records.empty()) {
+                if (running) {
+                    std::this_thread::sleep_for(s_idle);
+                }
+                continue;
+            }
+            std::sort(records.begin(), records.end(), [](const record_type & lhs, const record_type & rhs){
+                return lhs.stamp != rhs.stamp ? lhs.stamp < rhs.stamp : lhs.order < rhs.order;
+            });
+            text.clear();
+            for (const record_type & record : records) {
+                format(text, record);
+            }
+            write(text);
+        }
+    }
+
+    void write(std::string_view text) {
+        while (!text.empty()) {
+            const ssize_t written = ::write(m_fd, text.data(), text.size());
+            if (written < 0 && errno == EINTR) {
+                continue;
+            } else if (written <= 0) {
+                return;
+            }
+            text.remove_prefix(written);
+        }
+    }
+
+    template<typename Integer>
+    static void append(std::string & text, Integer value, int base = 10) {
+        std::array<char, 24> digits;
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value, base);
+        text.append(digits.data(), result.ptr);
+    }
+
+    static void format(std::string & text, const record_type & record) {
+        switch (record.kind) {
+        case kind_type::joystick: {
+            const struct js_event & event = record.joystick.event;
+            text += " joystick: ";
+            append(text, record.joystick.device);
+            text += ", ";
+            if (event.type & JS_EVENT_INIT) {
+                text += "init ";
+            }
+            text += (event.type & ~JS_EVENT_INIT) == JS_EVENT_AXIS ? "axis: " : "button: ";
+            append(text, static_cast<unsigned>(event.number));
+            text += ", value: ";
+            append(text, static_cast<int>(event.value));
+            text += ", time: ";
+            append(text, event.time);
+            text += "ms\n";
+            break;
+        }
+        case kind_type::gpio:
+            text += " timestamp_ns: ";
+            append(text, record.gpio.timestamp_ns);
+            text += ", id: ";
+            append(text, record.gpio.id);
+            text += ", offset: ";
+            append(text, record.gpio.offset);
+            text += ", seqno: ";
+            append(text, record.gpio.seqno);
+            text += ", line_seqno: ";
+            append(text, record.gpio.line_seqno);
+            text += '\n';
+            break;
+        case kind_type::added:
+            text += "+joystick: ";
+            append(text, record.added.device);
+            text += ", name: \"";
+            text += record.added.name;
+            text += "\", version: 0x";
+            append(text, record.added.version, 16);
+            text += ", axes: ";
+            append(text, record.added.axes);
+            text += ", buttons: ";
+            append(text, record.added.buttons);
+            text += '\n';
+            break;
+        case kind_type::removed:
+            text += "-joystick: ";
+            append(text, record.removed.device);
+            text += '\n';
+            break;
+        }
+    }
+
+    const level_type m_level;
+    const int m_fd;
+    const std::uint64_t m_id;
+    std::array<std::atomic<ring_type *>, s_rings> m_rings{};
+    std::atomic<count_type> m_dropped{0};
+    std::atomic<bool> m_running{false};
+    std::thread m_drainer;
+};
+
+#endif // EVENT_LOGGER_HPP
@@ -0,0 +1,60 @@
+#ifndef FRAME_BUFFER_HPP
+#define FRAME_BUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief Triple buffer publishing whole frames from any number of writers to a single reader
+ *
+ * Writers serialize on a mutex, apply their change to the pending frame and
+ * publish a complete copy of it with one atomic exchange.  The reader never
+ * blocks: acquire() swaps in the latest published frame, if any, and the
+ * returned reference stays valid and unchanged until its next acquire().
+ */
+template<typename Frame>
+class frame_buffer {
+public:
+    typedef Frame frame_type;
+
+    frame_buffer() = default;
+    frame_buffer(const frame_buffer &) = delete;
+    frame_buffer(frame_buffer &&) = delete;
+    frame_buffer & operator=(const frame_buffer &) = delete;
+    frame_buffer & operator=(frame_buffer &&) = delete;
+    ~frame_buffer() = default;
+
+    template<typename Function>
+    void modify(Function && function) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        std::forward<Function>(function)(m_pending);
+        m_frames[m_back] = m_pending;
+        m_back = m_middle.exchange(m_back | s_fresh, std::memory_order_acq_rel) & s_index;
+    }
+
+    const frame_type & acquire() {
+        if (m_middle.load(std::memory_order_relaxed) & s_fresh) {
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & s_index;
+        }
+        return m_frames[m_front];
+    }
+
+private:
+    static constexpr std::uint8_t s_index = 0x3;
+    static constexpr std::uint8_t s_fresh = 0x4;
+
+    std::array<frame_type, 3> m_frames{};
+
+    alignas(64) std::mutex m_mutex;
+    frame_type m_pending{};
+    std::uint8_t m_back = 0;
+
+    alignas(64) std::atomic<std::uint8_t> m_middle{1};
+
+    alignas(64) std::uint8_t m_front = 2;
+};
+
+#endif // FRAME_BUFFER_HPP
@@ -8,7 +8,9 @@ extern "C" {
 
 #include <asio/posix/stream_descriptor.hpp>
 
+#include "detail/read_handler.hpp"
 #include "gpio_line_info_changed_results.hpp"
+#include "io_ring.hpp"
 
 class gpio_chip_descriptor {
 public:
@@ -41,17 +43,12 @@ public:
 
     template<typename MutableBufferSequence, typename LineInfoChangedHandler>
     void async_read_line_info_changes(const MutableBufferSequence & buffers, LineInfoChangedHandler && handler) {
-        m_stream.async_read_some(buffers,
-            [buffers,handler=std::forward<LineInfoChangedHandler>(handler)](const asio::error_code & error, std::size_t bytes_transferred){
-                handler(
-                    error,
-                    gpio_line_info_changed_results<MutableBufferSequence>(
-                        asio::buffers_begin(buffers),
-                        error ? asio::buffers_begin(buffers) : asio::buffers_begin(buffers) + bytes_transferred
-                    )
-                );
-            }
-        );
+        auto read_handler = detail::make_read_handler<gpio_line_info_changed_results<MutableBufferSequence>>(buffers, std::forward<LineInfoChangedHandler>(handler));
+        if (m_ring) {
+            m_ring->async_read_some(m_stream.native_handle(), buffers, std::move(read_handler));
+        } else {
+            m_stream.async_read_some(buffers, std::move(read_handler));
+        }
     }
 
     template<typename WaitHandler>
@@ -59,19 +56,41 @@ public:
         return m_stream.async_wait(w, std::forward<WaitHandler>(handler));
     }
 
+    /**
+     * @brief Read through ring from now on instead of through the io_context's reactor
+     *
+     * The descriptor is made non-blocking, so the kernel polls it instead of
+     * parking a worker thread in the driver for each read.
+     */
+    void attach(io_ring & ring) {
+        m_stream.native_non_blocking(true);
+        m_ring = &ring;
+    }
+
+    void attach(io_ring & ring, asio::error_code & ec) {
+        m_stream.native_non_blocking(true, ec);
+        if (!ec) {
+            m_ring = &ring;
+        }
+    }
+
     void cancel() {
+        cancel_ring();
         return m_stream.cancel();
     }
 
     void cancel(asio::error_code & ec) {
+        cancel_ring();
         m_stream.cancel(ec);
     }
 
     void close() {
+        cancel_ring();
         return m_stream.close();
     }
 
     void close(asio::error_code & ec) {
+        cancel_ring();
         m_stream.close(ec);
     }
 
@@ -226,8 +245,8 @@ public:
     gpio_line_info_changed_results<MutableBufferSequence> read_line_info_changes(const MutableBufferSequence & buffers) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers);
         return gpio_line_info_changed_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
@@ -235,12 +254,13 @@ public:
     gpio_line_info_changed_results<MutableBufferSequence> read_line_info_changes(const MutableBufferSequence & buffers, asio::error_code & ec) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers, ec);
         return gpio_line_info_changed_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            ec ? asio::buffers_begin(buffers) : asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            ec ? detail::buffers_begin(buffers) : detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
     native_handle_type release() {
+        cancel_ring();
         return m_stream.release();
     }
 
@@ -253,7 +273,14 @@ public:
     }
 
 private:
+    void cancel_ring() {
+        if (m_ring && m_stream.is_open()) {
+            m_ring->cancel(m_stream.native_handle());
+        }
+    }
+
     asio::posix::stream_descriptor m_stream;
+    io_ring * m_ring = nullptr;
 };
 
 #endif // GPIO_CHIP_DESCRIPTOR_HPP
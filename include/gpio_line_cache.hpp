@@ -0,0 +1,158 @@
+#ifndef GPIO_LINE_CACHE_HPP
+#define GPIO_LINE_CACHE_HPP
+
+extern "C" {
+#include <linux/gpio.h>
+} // extern "C"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+#include "gpio_line_descriptor.hpp"
+#include "histogram.hpp"
+
+/**
+ * @brief Remembers the last config and values applied to a line request and elides redundant writes
+ *
+ * set_config() is skipped when the config is identical to the last one
+ * applied.  set_values() only touches lines that are not already known to
+ * hold the requested value, and is skipped entirely when none remain.  Any
+ * failed ioctl forgets the cached state, so the next write always goes out.
+ * The latency of every ioctl that does go out is recorded in nanoseconds.
+ */
+class gpio_line_cache {
+public:
+    typedef std::uint64_t count_type;
+
+    gpio_line_cache() = delete;
+    gpio_line_cache(gpio_line_descriptor & line) :
+        m_line(line)
+    {}
+    gpio_line_cache(const gpio_line_cache &) = delete;
+    gpio_line_cache(gpio_line_cache &&) = delete;
+    gpio_line_cache & operator=(const gpio_line_cache &) = delete;
+    gpio_line_cache & operator=(gpio_line_cache &&) = delete;
+    ~gpio_line_cache() = default;
+
+    void set_config(const struct gpio_v2_line_config & config) {
+        asio::error_code ec;
+        set_config(config, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void set_config(const struct gpio_v2_line_config & config, asio::error_code & ec) {
+        if (m_configured && std::memcmp(&m_config, &config, sizeof(config)) == 0) {
+            m_configs_elided.fetch_add(1, std::memory_order_relaxed);
+            ec = asio::error_code();
+            return;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        m_line.set_config(config, ec);
+        m_config_latency.record(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+        m_configs_written.fetch_add(1, std::memory_order_relaxed);
+        if (ec) {
+            invalidate();
+            return;
+        }
+        m_config = config;
+        m_configured = true;
+
+        // Output lines take the values carried by the config, or zero, so they are known afterwards
+        std::uint64_t outputs = config.flags & GPIO_V2_LINE_FLAG_OUTPUT ? ~std::uint64_t(0) : 0;
+        std::uint64_t bits = 0;
+        for (std::uint32_t i = 0; i != config.num_attrs && i != GPIO_V2_LINE_NUM_ATTRS_MAX; ++i) {
+            const struct gpio_v2_line_config_attribute & attribute = config.attrs[i];
+            if (attribute.attr.id == GPIO_V2_LINE_ATTR_ID_FLAGS) {
+                outputs = attribute.attr.flags & GPIO_V2_LINE_FLAG_OUTPUT ?
+                    outputs | attribute.mask :
+                    outputs & ~attribute.mask;
+            } else if (attribute.attr.id == GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES) {
+                bits = (bits & ~attribute.mask) | (attribute.attr.values & attribute.mask);
+            }
+        }
+        m_known = outputs;
+        m_bits = bits & outputs;
+    }
+
+    void set_values(const struct gpio_v2_line_values & values) {
+        asio::error_code ec;
+        set_values(values, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void set_values(const struct gpio_v2_line_values & values, asio::error_code & ec) {
+        const std::uint64_t changed = values.mask & (~m_known | (values.bits ^ m_bits));
+        if (!changed) {
+            m_values_elided.fetch_add(1, std::memory_order_relaxed);
+            ec = asio::error_code();
+            return;
+        }
+        struct gpio_v2_line_values update;
+        update.bits = values.bits & changed;
+        update.mask = changed;
+        const auto start = std::chrono::steady_clock::now();
+        m_line.set_values(update, ec);
+        m_values_latency.record(std::chrono::nanoseconds(std::chrono::steady_clock::now() - start).count());
+        m_values_written.fetch_add(1, std::memory_order_relaxed);
+        if (ec) {
+            invalidate();
+            return;
+        }
+        m_bits = (m_bits & ~changed) | update.bits;
+        m_known |= changed;
+    }
+
+    void invalidate() {
+        m_configured = false;
+        m_known = 0;
+        m_bits = 0;
+    }
+
+    count_type configs_written() const {
+        return m_configs_written.load(std::memory_order_relaxed);
+    }
+
+    count_type configs_elided() const {
+        return m_configs_elided.load(std::memory_order_relaxed);
+    }
+
+    count_type values_written() const {
+        return m_values_written.load(std::memory_order_relaxed);
+    }
+
+    count_type values_elided() const {
+        return m_values_elided.load(std::memory_order_relaxed);
+    }
+
+    const concurrent_histogram & config_latency() const {
+        return m_config_latency;
+    }
+
+    const concurrent_histogram & values_latency() const {
+        return m_values_latency;
+    }
+
+private:
+    gpio_line_descriptor & m_line;
+
+    struct gpio_v2_line_config m_config;
+    bool m_configured = false;
+    std::uint64_t m_known = 0;
+    std::uint64_t m_bits = 0;
+
+    std::atomic<count_type> m_configs_written{0};
+    std::atomic<count_type> m_configs_elided{0};
+    std::atomic<count_type> m_values_written{0};
+    std::atomic<count_type> m_values_elided{0};
+
+    concurrent_histogram m_config_latency;
+    concurrent_histogram m_values_latency;
+};
+
+#endif // GPIO_LINE_CACHE_HPP
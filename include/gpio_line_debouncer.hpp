@@ -0,0 +1,141 @@
+#ifndef GPIO_LINE_DEBOUNCER_HPP
+#define GPIO_LINE_DEBOUNCER_HPP
+
+extern "C" {
+#include <linux/gpio.h>
+} // extern "C"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/**
+ * @brief Filters bounce edges out of a stream of line events using their kernel timestamps
+ *
+ * Like the kernel's own debounce, an edge is only passed on once its line
+ * has settled: it is held until the period has passed without a further
+ * edge, and an edge that arrives sooner replaces it.  A settled edge in the
+ * same direction as the last one passed on is dropped, since the line ended
+ * up where it was.  Edges settle as later ones arrive, or when settle() is
+ * called once deadline() has passed.  A zero period passes every event on
+ * immediately.
+ */
+class gpio_line_debouncer {
+public:
+    typedef std::chrono::nanoseconds duration;
+    typedef std::uint64_t count_type;
+
+    gpio_line_debouncer() = default;
+    gpio_line_debouncer(duration period) :
+        m_period(period)
+    {}
+    gpio_line_debouncer(const gpio_line_debouncer &) = default;
+    gpio_line_debouncer(gpio_line_debouncer &&) = default;
+    gpio_line_debouncer & operator=(const gpio_line_debouncer &) = default;
+    gpio_line_debouncer & operator=(gpio_line_debouncer &&) = default;
+    ~gpio_line_debouncer() = default;
+
+    duration period() const {
+        return m_period;
+    }
+
+    void period(duration period) {
+        m_period = period;
+    }
+
+    /**
+     * @brief Hold event until its line settles, calling function with any edge that settled before it
+     */
+    template<typename Function>
+    void push(const struct gpio_v2_line_event & event, Function && function) {
+        if (m_period == duration::zero()) {
+            function(event);
+            return;
+        }
+        line_type * line = nullptr;
+        for (std::size_t i = 0; i != m_size && !line; ++i) {
+            if (m_lines[i].event.offset == event.offset) {
+                line = &m_lines[i];
+            }
+        }
+        if (!line) {
+            if (m_size == m_lines.size()) {
+                function(event);
+                return;
+            }
+            line = &m_lines[m_size++];
+            line->id = 0;
+        } else if (line->pending) {
+            if (event.timestamp_ns - line->event.timestamp_ns < static_cast<std::uint64_t>(m_period.count())) {
+                ++m_rejected;
+            } else {
+                commit(*line, function);
+            }
+        }
+        line->event = event;
+        line->pending = true;
+    }
+
+    /**
+     * @brief Pass on every held edge whose line has been quiet for the period by now_ns
+     */
+    template<typename Function>
+    void settle(std::uint64_t now_ns, Function && function) {
+        for (std::size_t i = 0; i != m_size; ++i) {
+            line_type & line = m_lines[i];
+            if (line.pending && now_ns - line.event.timestamp_ns >= static_cast<std::uint64_t>(m_period.count())) {
+                commit(line, function);
+            }
+        }
+    }
+
+    /**
+     * @brief Return when the earliest held edge settles, in kernel timestamp nanoseconds
+     */
+    std::optional<std::uint64_t> deadline() const {
+        std::optional<std::uint64_t> deadline;
+        for (std::size_t i = 0; i != m_size; ++i) {
+            if (m_lines[i].pending) {
+                const std::uint64_t settled = m_lines[i].event.timestamp_ns + m_period.count();
+                deadline = deadline ? std::min(*deadline, settled) : settled;
+            }
+        }
+        return deadline;
+    }
+
+    void clear() {
+        m_size = 0;
+    }
+
+    count_type rejected() const {
+        return m_rejected;
+    }
+
+private:
+    struct line_type {
+        struct gpio_v2_line_event event;
+        std::uint32_t id;
+        bool pending;
+    };
+
+    template<typename Function>
+    void commit(line_type & line, Function & function) {
+        line.pending = false;
+        if (line.event.id == line.id) {
+            ++m_rejected;
+            return;
+        }
+        line.id = line.event.id;
+        function(line.event);
+    }
+
+    duration m_period = duration::zero();
+    std::array<line_type, GPIO_V2_LINES_MAX> m_lines;
+    std::size_t m_size = 0;
+    count_type m_rejected = 0;
+};
+
+#endif // GPIO_LINE_DEBOUNCER_HPP
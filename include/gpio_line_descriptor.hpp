@@ -10,7 +10,9 @@ extern "C" {
 #include <asio/posix/stream_descriptor.hpp>
 #include <asio/read.hpp>
 
+#include "detail/read_handler.hpp"
 #include "gpio_line_event_results.hpp"
+#include "io_ring.hpp"
 
 class gpio_line_descriptor {
 public:
@@ -43,17 +45,12 @@ public:
 
     template<typename MutableBufferSequence, typename EventHandler>
     void async_read_line_events(const MutableBufferSequence & buffers, EventHandler && handler) {
-        m_stream.async_read_some(
-            buffers,
-            [buffers,handler=std::forward<EventHandler>(handler)](const asio::error_code & error, std::size_t bytes_transferred){
-                handler(
-                    error, gpio_line_event_results<MutableBufferSequence>(
-                        asio::buffers_begin(buffers),
-                        error ? asio::buffers_begin(buffers) : asio::buffers_begin(buffers) + bytes_transferred
-                    )
-                );
-            }
-        );
+        auto read_handler = detail::make_read_handler<gpio_line_event_results<MutableBufferSequence>>(buffers, std::forward<EventHandler>(handler));
+        if (m_ring) {
+            m_ring->async_read_some(m_stream.native_handle(), buffers, std::move(read_handler));
+        } else {
+            m_stream.async_read_some(buffers, std::move(read_handler));
+        }
     }
 
     template<typename WaitHandler>
@@ -61,19 +58,41 @@ public:
         return m_stream.async_wait(w, std::forward<WaitHandler>(handler));
     }
 
+    /**
+     * @brief Read through ring from now on instead of through the io_context's reactor
+     *
+     * The descriptor is made non-blocking, so the kernel polls it instead of
+     * parking a worker thread in the driver for each read.
+     */
+    void attach(io_ring & ring) {
+        m_stream.native_non_blocking(true);
+        m_ring = &ring;
+    }
+
+    void attach(io_ring & ring, asio::error_code & ec) {
+        m_stream.native_non_blocking(true, ec);
+        if (!ec) {
+            m_ring = &ring;
+        }
+    }
+
     void cancel() {
+        cancel_ring();
         return m_stream.cancel();
     }
 
     void cancel(asio::error_code & ec) {
+        cancel_ring();
         m_stream.cancel(ec);
     }
 
     void close() {
+        cancel_ring();
         return m_stream.close();
     }
 
     void close(asio::error_code & ec) {
+        cancel_ring();
         m_stream.close(ec);
     }
 
@@ -150,8 +169,8 @@ public:
     gpio_line_event_results<MutableBufferSequence> read_line_events(const MutableBufferSequence & buffers) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers);
         return gpio_line_event_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
@@ -159,16 +178,17 @@ public:
     gpio_line_event_results<MutableBufferSequence> read_line_events(const MutableBufferSequence & buffers, asio::error_code & ec) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers, ec);
         return gpio_line_event_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
     native_handle_type release() {
+        cancel_ring();
         return m_stream.release();
     }
 
-    void set_config(struct gpio_v2_line_config & config) {
+    void set_config(const struct gpio_v2_line_config & config) {
         asio::error_code ec;
         set_config(config, ec);
         if (ec) {
@@ -176,14 +196,14 @@ public:
         }
     }
 
-    void set_config(struct gpio_v2_line_config & config, asio::error_code & ec) {
+    void set_config(const struct gpio_v2_line_config & config, asio::error_code & ec) {
         ec = asio::error_code(
             ::ioctl(m_stream.native_handle(), GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0 ? errno : 0,
             asio::error::system_category
         );
     }
 
-    void set_values(struct gpio_v2_line_values & values) {
+    void set_values(const struct gpio_v2_line_values & values) {
         asio::error_code ec;
         set_values(values, ec);
         if (ec) {
@@ -191,7 +211,7 @@ public:
         }
     }
 
-    void set_values(struct gpio_v2_line_values & values, asio::error_code & ec) {
+    void set_values(const struct gpio_v2_line_values & values, asio::error_code & ec) {
         ec = asio::error_code(
             ::ioctl(m_stream.native_handle(), GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0 ? errno : 0,
             asio::error::system_category
@@ -207,7 +227,14 @@ public:
     }
 
 private:
+    void cancel_ring() {
+        if (m_ring && m_stream.is_open()) {
+            m_ring->cancel(m_stream.native_handle());
+        }
+    }
+
     asio::posix::stream_descriptor m_stream;
+    io_ring * m_ring = nullptr;
 };
 
 #endif // GPIO_LINE_DESCRIPTOR_HPP
@@ -5,11 +5,11 @@ extern "C" {
 #include <linux/gpio.h>
 } // extern "C"
 
-#include <asio/buffers_iterator.hpp>
+#include "detail/buffer_state.hpp"
 
 template<typename BufferSequence, typename ByteType = char>
 struct gpio_line_event_parser {
-    using state_type = asio::buffers_iterator<BufferSequence, ByteType>;
+    using state_type = typename detail::buffer_state<BufferSequence, ByteType>::type;
 
     using difference_type = std::ptrdiff_t;
     using value_type = struct gpio_v2_line_event;
@@ -19,8 +19,11 @@ struct gpio_line_event_parser {
 
     gpio_line_event_parser(state_type state) : m_state(std::move(state)) {}
 
+    const state_type & state() const {
+        return m_state;
+    }
     reference dereference() const {
-        return *reinterpret_cast<pointer>(m_state.operator->());
+        return *reinterpret_cast<pointer>(&*m_state);
     }
     void increment() {
         m_state += sizeof(value_type);
@@ -31,7 +34,7 @@ struct gpio_line_event_parser {
     void advance(difference_type difference) {
         m_state += sizeof(value_type) * difference;
     }
-    difference_type difference(const state_type & rhs) {
+    difference_type difference(const state_type & rhs) const {
         return (m_state - rhs) / sizeof(value_type);
     }
     friend bool operator==(const gpio_line_event_parser & lhs, const gpio_line_event_parser & rhs) {
@@ -0,0 +1,113 @@
+#ifndef GPIO_LINE_SEQUENCE_TRACKER_HPP
+#define GPIO_LINE_SEQUENCE_TRACKER_HPP
+
+extern "C" {
+#include <linux/gpio.h>
+} // extern "C"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Counts line events lost by the kernel from gaps in their sequence numbers
+ *
+ * seqno numbers every event of a line request from 1 and line_seqno every
+ * event of one line from 1, so any jump past the next number is events that
+ * overflowed the kernel queue.  The request-wide seqno gives the total, the
+ * per-line numbers attribute it, and the largest single gap is how much
+ * deeper the queue would have needed to be.
+ */
+class gpio_line_sequence_tracker {
+public:
+    typedef std::chrono::steady_clock clock_type;
+    typedef std::uint64_t count_type;
+
+    gpio_line_sequence_tracker() :
+        m_start(clock_type::now())
+    {}
+    gpio_line_sequence_tracker(const gpio_line_sequence_tracker &) = default;
+    gpio_line_sequence_tracker(gpio_line_sequence_tracker &&) = default;
+    gpio_line_sequence_tracker & operator=(const gpio_line_sequence_tracker &) = default;
+    gpio_line_sequence_tracker & operator=(gpio_line_sequence_tracker &&) = default;
+    ~gpio_line_sequence_tracker() = default;
+
+    void record(const struct gpio_v2_line_event & event) {
+        ++m_events;
+        if (event.seqno > m_seqno + 1) {
+            const count_type gap = event.seqno - m_seqno - 1;
+            m_dropped += gap;
+            m_largest_gap = std::max(m_largest_gap, gap);
+        }
+        m_seqno = std::max<count_type>(m_seqno, event.seqno);
+
+        line_type * line = nullptr;
+        for (std::size_t i = 0; i != m_size && !line; ++i) {
+            if (m_lines[i].offset == event.offset) {
+                line = &m_lines[i];
+            }
+        }
+        if (!line) {
+            if (m_size == m_lines.size()) {
+                return;
+            }
+            line = &m_lines[m_size++];
+            line->offset = event.offset;
+        }
+        if (event.line_seqno > line->seqno + 1) {
+            line->dropped += event.line_seqno - line->seqno - 1;
+        }
+        line->seqno = std::max<count_type>(line->seqno, event.line_seqno);
+    }
+
+    count_type events() const {
+        return m_events;
+    }
+
+    count_type dropped() const {
+        return m_dropped;
+    }
+
+    /**
+     * @brief Return the events dropped on one line, by offset
+     */
+    count_type dropped(std::uint32_t offset) const {
+        for (std::size_t i = 0; i != m_size; ++i) {
+            if (m_lines[i].offset == offset) {
+                return m_lines[i].dropped;
+            }
+        }
+        return 0;
+    }
+
+    count_type largest_gap() const {
+        return m_largest_gap;
+    }
+
+    /**
+     * @brief Return the dropped events per second since tracking started
+     */
+    double rate() const {
+        const std::chrono::duration<double> elapsed = clock_type::now() - m_start;
+        return elapsed.count() > 0 ? m_dropped / elapsed.count() : 0;
+    }
+
+private:
+    struct line_type {
+        std::uint32_t offset;
+        count_type seqno = 0;
+        count_type dropped = 0;
+    };
+
+    clock_type::time_point m_start;
+    count_type m_seqno = 0;
+    count_type m_events = 0;
+    count_type m_dropped = 0;
+    count_type m_largest_gap = 0;
+    std::array<line_type, GPIO_V2_LINES_MAX> m_lines;
+    std::size_t m_size = 0;
+};
+
+#endif // GPIO_LINE_SEQUENCE_TRACKER_HPP
@@ -0,0 +1,147 @@
+#ifndef HANDLER_ALLOCATOR_HPP
+#define HANDLER_ALLOCATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A few fixed blocks of handler storage, recycled by a read loop from one operation to the next
+ *
+ * asio frees an operation's storage before invoking its handler, so a loop
+ * that starts its next operation from the handler reuses the same block
+ * every time.  Requests that do not fit, or find every block taken, fall
+ * back to the heap.  Blocks are only handed out from the strand that owns
+ * the loop, or from asio while it runs an operation of that loop.
+ */
+class handler_memory {
+public:
+    static constexpr std::size_t s_size = 512;
+    static constexpr std::size_t s_blocks = 2;
+
+    handler_memory() = default;
+    handler_memory(const handler_memory &) = delete;
+    handler_memory(handler_memory &&) = delete;
+    handler_memory & operator=(const handler_memory &) = delete;
+    handler_memory & operator=(handler_memory &&) = delete;
+    ~handler_memory() = default;
+
+    void * allocate(std::size_t size) {
+        if (size <= s_size) {
+            for (block_type & block : m_blocks) {
+                if (!block.used) {
+                    block.used = true;
+                    return &block.storage;
+                }
+            }
+        }
+        return ::operator new(size);
+    }
+
+    void deallocate(void * pointer) {
+        for (block_type & block : m_blocks) {
+            if (pointer == &block.storage) {
+                block.used = false;
+                return;
+            }
+        }
+        ::operator delete(pointer);
+    }
+
+private:
+    struct block_type {
+        std::aligned_storage_t<s_size> storage;
+        bool used = false;
+    };
+
+    std::array<block_type, s_blocks> m_blocks;
+};
+
+/**
+ * @brief Allocator drawing from a handler_memory, as the associated allocator of a handler
+ */
+template<typename T>
+class handler_allocator {
+public:
+    typedef T value_type;
+
+    handler_allocator() = delete;
+    explicit handler_allocator(handler_memory & memory) :
+        m_memory(&memory)
+    {}
+    template<typename U>
+    handler_allocator(const handler_allocator<U> & other) noexcept :
+        m_memory(other.m_memory)
+    {}
+    handler_allocator(const handler_allocator &) = default;
+    handler_allocator(handler_allocator &&) = default;
+    handler_allocator & operator=(const handler_allocator &) = default;
+    handler_allocator & operator=(handler_allocator &&) = default;
+    ~handler_allocator() = default;
+
+    T * allocate(std::size_t n) const {
+        return static_cast<T *>(m_memory->allocate(sizeof(T) * n));
+    }
+
+    void deallocate(T * pointer, std::size_t) const {
+        m_memory->deallocate(pointer);
+    }
+
+    template<typename U>
+    friend bool operator==(const handler_allocator & lhs, const handler_allocator<U> & rhs) noexcept {
+        return lhs.m_memory == rhs.m_memory;
+    }
+
+    template<typename U>
+    friend bool operator!=(const handler_allocator & lhs, const handler_allocator<U> & rhs) noexcept {
+        return lhs.m_memory != rhs.m_memory;
+    }
+
+private:
+    template<typename> friend class handler_allocator;
+
+    handler_memory * m_memory;
+};
+
+/**
+ * @brief Handler whose associated allocator draws from a handler_memory
+ */
+template<typename Handler>
+class custom_alloc_handler {
+public:
+    typedef handler_allocator<Handler> allocator_type;
+
+    custom_alloc_handler() = delete;
+    template<typename DeducedHandler>
+    custom_alloc_handler(handler_memory & memory, DeducedHandler && handler) :
+        m_memory(&memory),
+        m_handler(std::forward<DeducedHandler>(handler))
+    {}
+    custom_alloc_handler(const custom_alloc_handler &) = default;
+    custom_alloc_handler(custom_alloc_handler &&) = default;
+    custom_alloc_handler & operator=(const custom_alloc_handler &) = default;
+    custom_alloc_handler & operator=(custom_alloc_handler &&) = default;
+    ~custom_alloc_handler() = default;
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(*m_memory);
+    }
+
+    template<typename... Args>
+    void operator()(Args &&... args) {
+        m_handler(std::forward<Args>(args)...);
+    }
+
+private:
+    handler_memory * m_memory;
+    Handler m_handler;
+};
+
+template<typename Handler>
+custom_alloc_handler<std::decay_t<Handler>> make_custom_alloc_handler(handler_memory & memory, Handler && handler) {
+    return custom_alloc_handler<std::decay_t<Handler>>(memory, std::forward<Handler>(handler));
+}
+
+#endif // HANDLER_ALLOCATOR_HPP
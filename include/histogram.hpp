@@ -0,0 +1,162 @@
+#ifndef HISTOGRAM_HPP
+#define HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief Log-linear histogram of 64-bit values with a bounded relative error
+ *
+ * Values below 2^s_precision get exact buckets.  Above that, every power of
+ * two is split into 2^s_precision linear sub-buckets, so a bucket is never
+ * wider than 1/16th of the values it holds.  Counters are relaxed atomics:
+ * any thread may record while another merges.
+ */
+class histogram {
+public:
+    typedef std::uint64_t value_type;
+    typedef std::uint64_t count_type;
+
+    histogram() = default;
+    histogram(const histogram &) = delete;
+    histogram(histogram &&) = delete;
+    histogram & operator=(const histogram &) = delete;
+    histogram & operator=(histogram &&) = delete;
+    ~histogram() = default;
+
+    void record(value_type value) {
+        m_counts[index(value)].fetch_add(1, std::memory_order_relaxed);
+        value_type max = m_max.load(std::memory_order_relaxed);
+        while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    void merge(const histogram & other) {
+        for (std::size_t i = 0; i != s_buckets; ++i) {
+            if (const count_type count = other.m_counts[i].load(std::memory_order_relaxed)) {
+                m_counts[i].fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+        const value_type max = other.m_max.load(std::memory_order_relaxed);
+        value_type current = m_max.load(std::memory_order_relaxed);
+        while (max > current && !m_max.compare_exchange_weak(current, max, std::memory_order_relaxed)) {}
+    }
+
+    count_type count() const {
+        count_type count = 0;
+        for (const std::atomic<count_type> & bucket : m_counts) {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    value_type max() const {
+        return m_max.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Return the upper bound of the bucket holding the given quantile, in [0, 1]
+     */
+    value_type percentile(double quantile) const {
+        const count_type total = count();
+        if (!total) {
+            return 0;
+        }
+        // Nearest rank: the smallest rank whose share of the samples reaches the quantile
+        const count_type rank = std::clamp<count_type>(static_cast<count_type>(std::ceil(std::clamp(quantile, 0.0, 1.0) * total)), 1, total);
+        count_type seen = 0;
+        for (std::size_t i = 0; i != s_buckets; ++i) {
+            seen += m_counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(upper(i), max());
+            }
+        }
+        return max();
+    }
+
+private:
+    static constexpr unsigned s_precision = 4;
+    static constexpr std::size_t s_sub_buckets = std::size_t(1) << s_precision;
+    static constexpr std::size_t s_buckets = (64 - s_precision + 1) * s_sub_buckets;
+
+    static std::size_t index(value_type value) {
+        if (value < s_sub_buckets) {
+            return value;
+        }
+        const unsigned shift = (63 - __builtin_clzll(value)) - s_precision;
+        return (shift + 1) * s_sub_buckets + ((value >> shift) & (s_sub_buckets - 1));
+    }
+
+    static value_type upper(std::size_t index) {
+        if (index < s_sub_buckets) {
+            return index;
+        }
+        const unsigned shift = index / s_sub_buckets - 1;
+        const value_type base = (s_sub_buckets | (index & (s_sub_buckets - 1))) << shift;
+        return base + ((value_type(1) << shift) - 1);
+    }
+
+    std::array<std::atomic<count_type>, s_buckets> m_counts{};
+    std::atomic<value_type> m_max{0};
+};
+
+/**
+ * @brief Histogram sharded per recording thread, merged on demand
+ *
+ * Each thread records into its own lazily allocated shard, so concurrent
+ * recorders never share a cache line in the common case.
+ */
+class concurrent_histogram {
+public:
+    typedef histogram::value_type value_type;
+
+    concurrent_histogram() = default;
+    concurrent_histogram(const concurrent_histogram &) = delete;
+    concurrent_histogram(concurrent_histogram &&) = delete;
+    concurrent_histogram & operator=(const concurrent_histogram &) = delete;
+    concurrent_histogram & operator=(concurrent_histogram &&) = delete;
+    ~concurrent_histogram() {
+        for (std::atomic<histogram *> & shard : m_shards) {
+            delete shard.load(std::memory_order_relaxed);
+        }
+    }
+
+    void record(value_type value) {
+        std::atomic<histogram *> & shard = m_shards[thread_index() % s_shards];
+        histogram * local = shard.load(std::memory_order_acquire);
+        if (!local) {
+            std::unique_ptr<histogram> created(new histogram());
+            if (shard.compare_exchange_strong(local, created.get(), std::memory_order_acq_rel)) {
+                local = created.release();
+            }
+        }
+        local->record(value);
+    }
+
+    std::unique_ptr<histogram> merged() const {
+        std::unique_ptr<histogram> result(new histogram());
+        for (const std::atomic<histogram *> & shard : m_shards) {
+            if (const histogram * const local = shard.load(std::memory_order_acquire)) {
+                result->merge(*local);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr std::size_t s_shards = 64;
+
+    static std::size_t thread_index() {
+        static std::atomic<std::size_t> s_next{0};
+        thread_local const std::size_t index = s_next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    std::array<std::atomic<histogram *>, s_shards> m_shards{};
+};
+
+#endif // HISTOGRAM_HPP
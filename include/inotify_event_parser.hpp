@@ -5,11 +5,11 @@ extern "C" {
 #include <sys/inotify.h>
 } // extern "C"
 
-#include <asio/buffers_iterator.hpp>
+#include "detail/buffer_state.hpp"
 
 template<typename BufferSequence, typename ByteType = char>
 struct inotify_event_parser {
-    using state_type = asio::buffers_iterator<BufferSequence, ByteType>;
+    using state_type = typename detail::buffer_state<BufferSequence, ByteType>::type;
 
     using difference_type = std::ptrdiff_t;
     using value_type = struct inotify_event;
@@ -19,8 +19,11 @@ struct inotify_event_parser {
 
     inotify_event_parser(state_type state) : m_state(std::move(state)) {}
 
+    const state_type & state() const {
+        return m_state;
+    }
     reference dereference() const {
-        return *reinterpret_cast<pointer>(m_state.operator->());
+        return *reinterpret_cast<pointer>(&*m_state);
     }
     void increment() {
         m_state += (sizeof(struct inotify_event) + dereference().len);
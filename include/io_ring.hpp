@@ -0,0 +1,697 @@
+#ifndef IO_RING_HPP
+#define IO_RING_HPP
+
+#if defined(TRAFFIC_IO_URING)
+extern "C" {
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+} // extern "C"
+#endif // TRAFFIC_IO_URING
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <asio/associated_allocator.hpp>
+#include <asio/associated_executor.hpp>
+#include <asio/buffer.hpp>
+#include <asio/error.hpp>
+#include <asio/executor_work_guard.hpp>
+#include <asio/io_context.hpp>
+#include <asio/posix/stream_descriptor.hpp>
+#include <asio/post.hpp>
+#include <asio/system_error.hpp>
+
+#if defined(TRAFFIC_IO_URING)
+
+/**
+ * @brief Reads descriptors through an io_uring instead of epoll and read(2)
+ *
+ * Reads queue submission entries from any thread and are submitted together
+ * by one io_uring_enter(2) posted to the io_context, so a burst of handlers
+ * re-arming their reads costs a single system call.  The ring signals
+ * completions through an eventfd the io_context waits on, and each wakeup
+ * reaps every completion queued so far.  Reads into a registered buffer use
+ * IORING_OP_READ_FIXED, sparing the kernel from pinning the pages each time.
+ *
+ * Descriptors should be non-blocking, so the kernel polls them rather than
+ * parking a worker thread in each driver's read.  Kernels that complete such
+ * a read with EAGAIN instead get an IORING_OP_POLL_ADD, and the read is
+ * submitted again once the descriptor is readable.
+ *
+ * Handlers complete through their associated executor, as with
+ * asio::posix::stream_descriptor, so a handler bound to a strand stays on it.
+ */
+class io_ring {
+public:
+    typedef asio::io_context::executor_type executor_type;
+    typedef std::uint64_t count_type;
+
+    static constexpr unsigned s_entries = 256;
+
+    io_ring() = delete;
+    io_ring(asio::io_context & io_context) :
+        m_context(io_context),
+        m_event(io_context)
+    {}
+    io_ring(const io_ring &) = delete;
+    io_ring(io_ring &&) = delete;
+    io_ring & operator=(const io_ring &) = delete;
+    io_ring & operator=(io_ring &&) = delete;
+    ~io_ring() {
+        close();
+    }
+
+    void open(unsigned entries = s_entries) {
+        asio::error_code ec;
+        open(entries, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void open(unsigned entries, asio::error_code & ec) {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        m_fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (m_fd == -1) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            return;
+        }
+
+        m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+        }
+        m_sq = ::mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sq == MAP_FAILED) {
+            m_sq = nullptr;
+            fail(ec);
+            return;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            m_cq = m_sq;
+        } else {
+            m_cq = ::mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            if (m_cq == MAP_FAILED) {
+                m_cq = nullptr;
+                fail(ec);
+                return;
+            }
+        }
+        m_sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+        void * const sqes = ::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            fail(ec);
+            return;
+        }
+        m_sqes = static_cast<struct io_uring_sqe *>(sqes);
+
+        char * const sq = static_cast<char *>(m_sq);
+        char * const cq = static_cast<char *>(m_cq);
+        m_sq_head = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+        m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        m_sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        m_sq_entries = params.sq_entries;
+        m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        m_cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+        // Entries are filled in ring order, so the index array never changes
+        unsigned * const array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        for (unsigned i = 0; i != m_sq_entries; ++i) {
+            array[i] = i;
+        }
+
+        const int event = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event == -1) {
+            fail(ec);
+            return;
+        }
+        m_event.assign(event, ec);
+        if (ec) {
+            ::close(event);
+            fail(ec);
+            return;
+        }
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_EVENTFD, &event, 1) == -1) {
+            fail(ec);
+            return;
+        }
+        ec = asio::error_code();
+        async_wait_completions();
+    }
+
+    bool is_open() const {
+        return m_fd != -1;
+    }
+
+    /**
+     * @brief Register memory that later reads may target with IORING_OP_READ_FIXED
+     *
+     * The memory must stay valid until the ring closes.  Registration can only
+     * happen once per ring.
+     */
+    template<typename MutableBufferSequence>
+    void register_buffers(const MutableBufferSequence & buffers) {
+        asio::error_code ec;
+        register_buffers(buffers, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    template<typename MutableBufferSequence>
+    void register_buffers(const MutableBufferSequence & buffers, asio::error_code & ec) {
+        std::vector<struct iovec> registered;
+        for (auto buffer = asio::buffer_sequence_begin(buffers); buffer != asio::buffer_sequence_end(buffers); ++buffer) {
+            const asio::mutable_buffer region(*buffer);
+            registered.push_back(iovec{region.data(), region.size()});
+        }
+        if (::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, registered.data(), registered.size()) == -1) {
+            ec = asio::error_code(errno, asio::error::system_category);
+            return;
+        }
+        m_registered = std::move(registered);
+        ec = asio::error_code();
+    }
+
+    template<typename MutableBufferSequence, typename ReadHandler>
+    void async_read_some(int fd, const MutableBufferSequence & buffers, ReadHandler && handler) {
+        typedef read_operation<std::decay_t<ReadHandler>> operation_type;
+        operation_type * const operation = operation_type::create(std::forward<ReadHandler>(handler), get_executor(), fd);
+
+        std::size_t count = 0;
+        for (auto buffer = asio::buffer_sequence_begin(buffers); buffer != asio::buffer_sequence_end(buffers) && count != operation->iovecs.size(); ++buffer) {
+            const asio::mutable_buffer region(*buffer);
+            operation->iovecs[count++] = iovec{region.data(), region.size()};
+        }
+
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            struct io_uring_sqe * sqe = acquire();
+            if (!sqe) {
+                submit_locked();
+                sqe = acquire();
+            }
+            if (sqe) {
+                const std::optional<std::uint16_t> index = count == 1 ? fixed(operation->iovecs[0]) : std::nullopt;
+                if (index) {
+                    operation->opcode = IORING_OP_READ_FIXED;
+                    operation->buf_index = *index;
+                    m_fixed.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    operation->opcode = IORING_OP_READV;
+                }
+                operation->addr = index ?
+                    reinterpret_cast<std::uint64_t>(operation->iovecs[0].iov_base) :
+                    reinterpret_cast<std::uint64_t>(operation->iovecs.data());
+                operation->len = index ? operation->iovecs[0].iov_len : count;
+                prepare_read(sqe, operation);
+                link(operation);
+                commit();
+                m_reads.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                operation->complete(asio::error::no_buffer_space, 0, true);
+                return;
+            }
+        }
+        schedule();
+    }
+
+    /**
+     * @brief Cancel every pending read of a descriptor, completing them with asio::error::operation_aborted
+     */
+    void cancel(int fd) {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        // A closed ring has already aborted everything it had pending
+        if (m_fd == -1) {
+            return;
+        }
+        for (operation_base * operation = m_pending; operation; operation = operation->next) {
+            if (operation->fd == fd && !operation->cancelled) {
+                struct io_uring_sqe * sqe = acquire();
+                if (!sqe) {
+                    submit_locked();
+                    sqe = acquire();
+                }
+                if (!sqe) {
+                    break;
+                }
+                sqe->opcode = IORING_OP_ASYNC_CANCEL;
+                sqe->fd = -1;
+                sqe->addr = reinterpret_cast<std::uint64_t>(operation) | (operation->polling ? s_poll_tag : 0);
+                sqe->user_data = 0;
+                commit();
+                operation->cancelled = true;
+            }
+        }
+        submit_locked();
+    }
+
+    void close() {
+        if (m_fd == -1) {
+            return;
+        }
+        asio::error_code ec;
+        m_event.close(ec);
+        // Closing the ring cancels whatever it still has in flight
+        ::close(m_fd);
+        m_fd = -1;
+        unmap();
+        while (operation_base * const operation = m_pending) {
+            unlink(operation);
+            operation->complete(asio::error::operation_aborted, 0, false);
+        }
+        m_registered.clear();
+    }
+
+    executor_type get_executor() {
+        return m_context.get_executor();
+    }
+
+    count_type reads() const {
+        return m_reads.load(std::memory_order_relaxed);
+    }
+
+    count_type fixed_reads() const {
+        return m_fixed.load(std::memory_order_relaxed);
+    }
+
+    count_type submits() const {
+        return m_submits.load(std::memory_order_relaxed);
+    }
+
+    count_type wakeups() const {
+        return m_wakeups.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct operation_base {
+        typedef void (*complete_type)(operation_base *, const asio::error_code &, std::size_t, bool);
+
+        void complete(const asio::error_code & error, std::size_t bytes_transferred, bool invoke) {
+            complete_function(this, error, bytes_transferred, invoke);
+        }
+
+        complete_type complete_function;
+        int fd;
+        std::uint8_t opcode = IORING_OP_READV;
+        std::uint16_t buf_index = 0;
+        std::uint64_t addr = 0;
+        std::uint32_t len = 0;
+        bool cancelled = false;
+        bool polling = false;
+        operation_base * next = nullptr;
+        operation_base * prev = nullptr;
+    };
+
+    /**
+     * @brief A read result bound to its handler, posted with the handler's allocator
+     */
+    template<typename Handler>
+    struct completion_handler {
+        typedef asio::associated_allocator_t<Handler> allocator_type;
+
+        allocator_type get_allocator() const noexcept {
+            return asio::get_associated_allocator(handler);
+        }
+
+        void operator()() {
+            handler(error, bytes_transferred);
+        }
+
+        Handler handler;
+        asio::error_code error;
+        std::size_t bytes_transferred;
+    };
+
+    template<typename Handler>
+    struct read_operation : operation_base {
+        typedef asio::associated_executor_t<Handler, executor_type> handler_executor_type;
+        typedef typename std::allocator_traits<asio::associated_allocator_t<Handler>>::template rebind_alloc<read_operation> allocator_type;
+
+        template<typename DeducedHandler>
+        read_operation(DeducedHandler && handler, const executor_type & executor, int fd) :
+            handler(std::forward<DeducedHandler>(handler)),
+            work(asio::get_associated_executor(this->handler, executor))
+        {
+            this->complete_function = &read_operation::do_complete;
+            this->fd = fd;
+        }
+
+        template<typename DeducedHandler>
+        static read_operation * create(DeducedHandler && handler, const executor_type & executor, int fd) {
+            allocator_type allocator(asio::get_associated_allocator(handler));
+            read_operation * const operation = std::allocator_traits<allocator_type>::allocate(allocator, 1);
+            std::allocator_traits<allocator_type>::construct(allocator, operation, std::forward<DeducedHandler>(handler), executor, fd);
+            return operation;
+        }
+
+        static void do_complete(operation_base * base, const asio::error_code & error, std::size_t bytes_transferred, bool invoke) {
+            read_operation * const operation = static_cast<read_operation *>(base);
+            allocator_type allocator(asio::get_associated_allocator(operation->handler));
+            Handler handler(std::move(operation->handler));
+            asio::executor_work_guard<handler_executor_type> work(std::move(operation->work));
+            // The operation is freed before the handler runs, so the handler may start the next read
+            std::allocator_traits<allocator_type>::destroy(allocator, operation);
+            std::allocator_traits<allocator_type>::deallocate(allocator, operation, 1);
+            if (invoke) {
+                asio::post(work.get_executor(), completion_handler<Handler>{std::move(handler), error, bytes_transferred});
+            }
+        }
+
+        Handler handler;
+        asio::executor_work_guard<handler_executor_type> work;
+        std::array<struct iovec, 16> iovecs;
+    };
+
+    // Poll completions carry their operation's address with the low bit set
+    static constexpr std::uint64_t s_poll_tag = 1;
+
+    void prepare_read(struct io_uring_sqe * sqe, operation_base * operation) {
+        sqe->opcode = operation->opcode;
+        sqe->buf_index = operation->buf_index;
+        sqe->fd = operation->fd;
+        sqe->off = ~std::uint64_t(0);
+        sqe->addr = operation->addr;
+        sqe->len = operation->len;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(operation);
+    }
+
+    void prepare_poll(struct io_uring_sqe * sqe, operation_base * operation) {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->fd = operation->fd;
+        sqe->poll_events = POLLIN;
+        sqe->user_data = reinterpret_cast<std::uint64_t>(operation) | s_poll_tag;
+    }
+
+    /**
+     * @brief Wait for a read that found nothing to read, or read again once a poll found data
+     */
+    asio::error_code retry(operation_base * operation, bool poll) {
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            if (operation->cancelled) {
+                return asio::error::operation_aborted;
+            }
+            struct io_uring_sqe * sqe = acquire();
+            if (!sqe) {
+                submit_locked();
+                sqe = acquire();
+            }
+            if (!sqe) {
+                return asio::error::no_buffer_space;
+            }
+            if (poll) {
+                prepare_poll(sqe, operation);
+            } else {
+                prepare_read(sqe, operation);
+            }
+            operation->polling = poll;
+            commit();
+        }
+        schedule();
+        return asio::error_code();
+    }
+
+    void fail(asio::error_code & ec) {
+        ec = asio::error_code(errno, asio::error::system_category);
+        close();
+    }
+
+    void unmap() {
+        if (m_sqes) {
+            ::munmap(m_sqes, m_sqes_size);
+            m_sqes = nullptr;
+        }
+        if (m_cq && m_cq != m_sq) {
+            ::munmap(m_cq, m_cq_size);
+        }
+        m_cq = nullptr;
+        if (m_sq) {
+            ::munmap(m_sq, m_sq_size);
+            m_sq = nullptr;
+        }
+    }
+
+    std::optional<std::uint16_t> fixed(const struct iovec & buffer) const {
+        const char * const begin = static_cast<const char *>(buffer.iov_base);
+        for (std::size_t index = 0; index != m_registered.size(); ++index) {
+            const char * const region = static_cast<const char *>(m_registered[index].iov_base);
+            if (begin >= region && begin + buffer.iov_len <= region + m_registered[index].iov_len) {
+                return static_cast<std::uint16_t>(index);
+            }
+        }
+        return std::nullopt;
+    }
+
+    // The submission queue is only touched with m_mutex held
+
+    struct io_uring_sqe * acquire() {
+        const unsigned tail = *m_sq_tail;
+        if (tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE) == m_sq_entries) {
+            return nullptr;
+        }
+        struct io_uring_sqe * const sqe = &m_sqes[tail & m_sq_mask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void commit() {
+        __atomic_store_n(m_sq_tail, *m_sq_tail + 1, __ATOMIC_RELEASE);
+    }
+
+    void submit_locked() {
+        const unsigned queued = *m_sq_tail - __atomic_load_n(m_sq_head, __ATOMIC_ACQUIRE);
+        if (queued == 0) {
+            return;
+        }
+        while (::syscall(__NR_io_uring_enter, m_fd, queued, 0, 0, nullptr, 0) == -1 && errno == EINTR) {}
+        m_submits.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void submit() {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_fd != -1) {
+            submit_locked();
+        }
+    }
+
+    /**
+     * @brief Submit everything queued so far with one system call, once the handlers already queued have run
+     */
+    void schedule() {
+        if (!m_scheduled.exchange(true, std::memory_order_acq_rel)) {
+            asio::post(m_context, [this](){
+                // Cleared first, so entries queued from here on schedule another submit
+                m_scheduled.store(false, std::memory_order_release);
+                submit();
+            });
+        }
+    }
+
+    void link(operation_base * operation) {
+        operation->next = m_pending;
+        operation->prev = nullptr;
+        if (m_pending) {
+            m_pending->prev = operation;
+        }
+        m_pending = operation;
+    }
+
+    void unlink(operation_base * operation) {
+        if (operation->prev) {
+            operation->prev->next = operation->next;
+        } else {
+            m_pending = operation->next;
+        }
+        if (operation->next) {
+            operation->next->prev = operation->prev;
+        }
+    }
+
+    void async_wait_completions() {
+        m_event.async_wait(asio::posix::stream_descriptor::wait_read, [this](const asio::error_code & error){
+            if (!error) {
+                reap();
+                async_wait_completions();
+            }
+        });
+    }
+
+    void reap() {
+        // Drain the eventfd first, so a completion posted while reaping wakes the next wait
+        std::uint64_t value;
+        while (::read(m_event.native_handle(), &value, sizeof(value)) == -1 && errno == EINTR) {}
+        m_wakeups.fetch_add(1, std::memory_order_relaxed);
+
+        unsigned head = *m_cq_head;
+        for (unsigned tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE); head != tail; tail = __atomic_load_n(m_cq_tail, __ATOMIC_ACQUIRE)) {
+            for (; head != tail; ++head) {
+                const struct io_uring_cqe & cqe = m_cqes[head & m_cq_mask];
+                const bool poll = cqe.user_data & s_poll_tag;
+                operation_base * const operation = reinterpret_cast<operation_base *>(cqe.user_data & ~s_poll_tag);
+                if (!operation) {
+                    continue;
+                }
+                const std::int32_t result = cqe.res;
+                asio::error_code error;
+                if (result == -EAGAIN || (poll && result > 0)) {
+                    error = retry(operation, !poll);
+                    if (!error) {
+                        continue;
+                    }
+                }
+                {
+                    const std::lock_guard<std::mutex> lock(m_mutex);
+                    unlink(operation);
+                }
+                if (error) {
+                    operation->complete(error, 0, true);
+                } else if (result > 0) {
+                    operation->complete(asio::error_code(), result, true);
+                } else if (result == 0) {
+                    operation->complete(asio::error::eof, 0, true);
+                } else if (result == -ECANCELED) {
+                    operation->complete(asio::error::operation_aborted, 0, true);
+                } else {
+                    operation->complete(asio::error_code(-result, asio::error::system_category), 0, true);
+                }
+            }
+            __atomic_store_n(m_cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+
+    asio::io_context & m_context;
+    asio::posix::stream_descriptor m_event;
+    int m_fd = -1;
+
+    std::mutex m_mutex;
+    void * m_sq = nullptr;
+    void * m_cq = nullptr;
+    std::size_t m_sq_size = 0;
+    std::size_t m_cq_size = 0;
+    std::size_t m_sqes_size = 0;
+    struct io_uring_sqe * m_sqes = nullptr;
+    unsigned * m_sq_head = nullptr;
+    unsigned * m_sq_tail = nullptr;
+    unsigned m_sq_mask = 0;
+    unsigned m_sq_entries = 0;
+    unsigned * m_cq_head = nullptr;
+    unsigned * m_cq_tail = nullptr;
+    unsigned m_cq_mask = 0;
+    struct io_uring_cqe * m_cqes = nullptr;
+    operation_base * m_pending = nullptr;
+    std::vector<struct iovec> m_registered;
+    std::atomic<bool> m_scheduled{false};
+
+    std::atomic<count_type> m_reads{0};
+    std::atomic<count_type> m_fixed{0};
+    std::atomic<count_type> m_submits{0};
+    std::atomic<count_type> m_wakeups{0};
+};
+
+#else // TRAFFIC_IO_URING
+
+/**
+ * @brief Stand-in for builds without io_uring support, which never opens
+ */
+class io_ring {
+public:
+    typedef asio::io_context::executor_type executor_type;
+    typedef std::uint64_t count_type;
+
+    static constexpr unsigned s_entries = 256;
+
+    io_ring() = delete;
+    io_ring(asio::io_context & io_context) :
+        m_context(io_context)
+    {}
+    io_ring(const io_ring &) = delete;
+    io_ring(io_ring &&) = delete;
+    io_ring & operator=(const io_ring &) = delete;
+    io_ring & operator=(io_ring &&) = delete;
+    ~io_ring() = default;
+
+    void open(unsigned entries = s_entries) {
+        asio::error_code ec;
+        open(entries, ec);
+        if (ec) {
+            throw asio::system_error(ec);
+        }
+    }
+
+    void open(unsigned, asio::error_code & ec) {
+        ec = asio::error::operation_not_supported;
+    }
+
+    bool is_open() const {
+        return false;
+    }
+
+    template<typename MutableBufferSequence>
+    void register_buffers(const MutableBufferSequence &) {
+        throw asio::system_error(asio::error::operation_not_supported);
+    }
+
+    template<typename MutableBufferSequence>
+    void register_buffers(const MutableBufferSequence &, asio::error_code & ec) {
+        ec = asio::error::operation_not_supported;
+    }
+
+    template<typename MutableBufferSequence, typename ReadHandler>
+    void async_read_some(int, const MutableBufferSequence &, ReadHandler && handler) {
+        const auto executor = asio::get_associated_executor(handler, get_executor());
+        asio::post(executor, [handler=std::forward<ReadHandler>(handler)]() mutable {
+            handler(asio::error::operation_not_supported, 0);
+        });
+    }
+
+    void cancel(int) {}
+
+    void close() {}
+
+    executor_type get_executor() {
+        return m_context.get_executor();
+    }
+
+    count_type reads() const {
+        return 0;
+    }
+
+    count_type fixed_reads() const {
+        return 0;
+    }
+
+    count_type submits() const {
+        return 0;
+    }
+
+    count_type wakeups() const {
+        return 0;
+    }
+
+private:
+    asio::io_context & m_context;
+};
+
+#endif // TRAFFIC_IO_URING
+
+#endif // IO_RING_HPP
@@ -0,0 +1,46 @@
+#ifndef JOYSTICK_CLOCK_HPP
+#define JOYSTICK_CLOCK_HPP
+
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief Maps the 32-bit millisecond js_event time of one device onto CLOCK_MONOTONIC
+ *
+ * joydev stamps events from jiffies, which runs at a fixed but unknown
+ * offset from CLOCK_MONOTONIC.  The smallest difference seen between the
+ * read time and the event time is taken as that offset, so the quickest
+ * delivery observed counts as instantaneous.  All arithmetic is modulo 2^32
+ * and survives the millisecond counter wrapping.
+ */
+class joystick_clock {
+public:
+    typedef std::uint32_t time_type;
+    typedef std::uint64_t stamp_type;
+
+    joystick_clock() = default;
+    joystick_clock(const joystick_clock &) = default;
+    joystick_clock(joystick_clock &&) = default;
+    joystick_clock & operator=(const joystick_clock &) = default;
+    joystick_clock & operator=(joystick_clock &&) = default;
+    ~joystick_clock() = default;
+
+    /**
+     * @brief Return the CLOCK_MONOTONIC nanoseconds of an event time, given when it was read
+     */
+    stamp_type monotonic(time_type time, stamp_type now) {
+        const time_type offset = static_cast<time_type>(now / 1000000) - time;
+        if (!m_synced || static_cast<std::int32_t>(offset - m_offset) < 0) {
+            m_offset = offset;
+            m_synced = true;
+        }
+        const stamp_type age = stamp_type(offset - m_offset) * 1000000;
+        return now - std::min(age, now);
+    }
+
+private:
+    time_type m_offset = 0;
+    bool m_synced = false;
+};
+
+#endif // JOYSTICK_CLOCK_HPP
@@ -10,6 +10,8 @@ extern "C" {
 
 #include <asio/posix/stream_descriptor.hpp>
 
+#include "detail/read_handler.hpp"
+#include "io_ring.hpp"
 #include "joystick_event_results.hpp"
 
 class joystick_descriptor {
@@ -48,17 +50,12 @@ public:
 
     template<typename MutableBufferSequence, typename EventHandler>
     void async_read_events(const MutableBufferSequence & buffers, EventHandler && handler) {
-        m_stream.async_read_some(buffers,
-            [buffers,handler=std::forward<EventHandler>(handler)](const asio::error_code & error, std::size_t bytes_transferred){
-                handler(
-                    error,
-                    joystick_event_results<MutableBufferSequence>(
-                        asio::buffers_begin(buffers),
-                        error ? asio::buffers_begin(buffers) : asio::buffers_begin(buffers) + bytes_transferred
-                    )
-                );
-            }
-        );
+        auto read_handler = detail::make_read_handler<joystick_event_results<MutableBufferSequence>>(buffers, std::forward<EventHandler>(handler));
+        if (m_ring) {
+            m_ring->async_read_some(m_stream.native_handle(), buffers, std::move(read_handler));
+        } else {
+            m_stream.async_read_some(buffers, std::move(read_handler));
+        }
     }
 
     template<typename WaitHandler>
@@ -66,6 +63,24 @@ public:
         return m_stream.async_wait(w, std::forward<WaitHandler>(handler));
     }
 
+    /**
+     * @brief Read through ring from now on instead of through the io_context's reactor
+     *
+     * The descriptor is made non-blocking, so the kernel polls it instead of
+     * parking a worker thread in the driver for each read.
+     */
+    void attach(io_ring & ring) {
+        m_stream.native_non_blocking(true);
+        m_ring = &ring;
+    }
+
+    void attach(io_ring & ring, asio::error_code & ec) {
+        m_stream.native_non_blocking(true, ec);
+        if (!ec) {
+            m_ring = &ring;
+        }
+    }
+
 
     axes_type axes() {
         asio::error_code ec;
@@ -104,18 +119,22 @@ public:
     }
 
     void cancel() {
+        cancel_ring();
         return m_stream.cancel();
     }
 
     void cancel(asio::error_code & ec) {
+        cancel_ring();
         m_stream.cancel(ec);
     }
 
     void close() {
+        cancel_ring();
         return m_stream.close();
     }
 
     void close(asio::error_code & ec) {
+        cancel_ring();
         m_stream.close(ec);
     }
 
@@ -195,8 +214,8 @@ public:
     joystick_event_results<MutableBufferSequence> read_events(const MutableBufferSequence & buffers) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers);
         return joystick_event_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
@@ -204,12 +223,13 @@ public:
     joystick_event_results<MutableBufferSequence> read_events(const MutableBufferSequence & buffers, asio::error_code & ec) {
         const std::size_t bytes_transferred = m_stream.read_some(buffers, ec);
         return joystick_event_results<MutableBufferSequence>(
-            asio::buffers_begin(buffers),
-            ec ? asio::buffers_begin(buffers) : asio::buffers_begin(buffers) + bytes_transferred
+            detail::buffers_begin(buffers),
+            ec ? detail::buffers_begin(buffers) : detail::buffers_begin(buffers) + bytes_transferred
         );
     }
 
     native_handle_type release() {
+        cancel_ring();
         return m_stream.release();
     }
 
@@ -240,7 +260,14 @@ public:
     }
 
 private:
+    void cancel_ring() {
+        if (m_ring && m_stream.is_open()) {
+            m_ring->cancel(m_stream.native_handle());
+        }
+    }
+
     asio::posix::stream_descriptor m_stream;
+    io_ring * m_ring = nullptr;
 };
 
 #endif // JOYSTICK_DESCRIPTOR_HPP
@@ -0,0 +1,124 @@
+#ifndef JOYSTICK_EVENT_COALESCER_HPP
+#define JOYSTICK_EVENT_COALESCER_HPP
+
+extern "C" {
+#include <linux/joystick.h>
+} // extern "C"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "joystick_event_columns.hpp"
+
+/**
+ * @brief Collapses a batch of joystick events to the final event per button and per axis
+ *
+ * Events are kept in the order each button or axis was last updated in the
+ * batch, carrying the value and time of that last event, so replaying them
+ * ends in the same state as applying the whole batch in order.
+ * JS_EVENT_INIT events coalesce with the button or axis they describe, and
+ * the flag stays set only if the last event for that input carried it.
+ * Each event may carry a CLOCK_MONOTONIC stamp in nanoseconds, or 0.
+ */
+class joystick_event_coalescer {
+public:
+    typedef struct js_event value_type;
+    typedef std::size_t size_type;
+    typedef std::uint64_t stamp_type;
+
+    joystick_event_coalescer() = default;
+    joystick_event_coalescer(const joystick_event_coalescer &) = default;
+    joystick_event_coalescer(joystick_event_coalescer &&) = default;
+    joystick_event_coalescer & operator=(const joystick_event_coalescer &) = default;
+    joystick_event_coalescer & operator=(joystick_event_coalescer &&) = default;
+    ~joystick_event_coalescer() = default;
+
+    void insert(const value_type & event, stamp_type stamp = 0) {
+        const std::uint8_t type = event.type & ~JS_EVENT_INIT;
+        if (type != JS_EVENT_BUTTON && type != JS_EVENT_AXIS) {
+            return;
+        }
+        const std::size_t index = (type == JS_EVENT_AXIS ? s_inputs : 0) + event.number;
+        touch(index);
+        m_events[index] = event;
+        m_stamps[index] = stamp;
+    }
+
+    template<typename Iterator>
+    void insert(Iterator begin, const Iterator & end) {
+        for (; begin != end; ++begin) {
+            insert(*begin);
+        }
+    }
+
+    /**
+     * @brief Insert decoded columns, stamping each event with stamp(time, type)
+     *
+     * The columns only hold button and axis events, so the loop needs no
+     * check of the type beyond choosing between buttons and axes.
+     */
+    template<std::size_t Capacity, typename Stamp>
+    void insert(const joystick_event_columns<Capacity> & columns, Stamp && stamp) {
+        const std::uint32_t * const times = columns.times();
+        const std::int16_t * const values = columns.values();
+        const std::uint8_t * const types = columns.types();
+        const std::uint8_t * const numbers = columns.numbers();
+        for (size_type i = 0; i != columns.size(); ++i) {
+            const std::size_t index = ((types[i] & ~JS_EVENT_INIT) == JS_EVENT_AXIS ? s_inputs : 0) + numbers[i];
+            touch(index);
+            m_events[index].time = times[i];
+            m_events[index].value = values[i];
+            m_events[index].type = types[i];
+            m_events[index].number = numbers[i];
+            m_stamps[index] = stamp(times[i], types[i]);
+        }
+    }
+
+    template<typename Function>
+    void for_each(Function && function) const {
+        for (size_type i = 0; i != m_size; ++i) {
+            function(m_events[m_order[i]], m_stamps[m_order[i]]);
+        }
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    size_type size() const {
+        return m_size;
+    }
+
+    void clear() {
+        for (size_type i = 0; i != m_size; ++i) {
+            m_pending[m_order[i]] = false;
+        }
+        m_size = 0;
+    }
+
+private:
+    static constexpr std::size_t s_inputs = 256;
+
+    /**
+     * @brief Make index the most recently updated input
+     */
+    void touch(std::size_t index) {
+        if (!m_pending[index]) {
+            m_pending[index] = true;
+            m_order[m_size++] = index;
+        } else if (m_order[m_size - 1] != index) {
+            const auto position = std::find(m_order.begin(), m_order.begin() + m_size, index);
+            std::rotate(position, position + 1, m_order.begin() + m_size);
+        }
+    }
+
+    std::array<value_type, 2 * s_inputs> m_events;
+    std::array<stamp_type, 2 * s_inputs> m_stamps;
+    std::array<bool, 2 * s_inputs> m_pending{};
+    std::array<std::uint16_t, 2 * s_inputs> m_order;
+    size_type m_size = 0;
+};
+
+#endif // JOYSTICK_EVENT_COALESCER_HPP
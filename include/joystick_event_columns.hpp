@@ -0,0 +1,247 @@
+#ifndef JOYSTICK_EVENT_COLUMNS_HPP
+#define JOYSTICK_EVENT_COLUMNS_HPP
+
+extern "C" {
+#include <linux/joystick.h>
+} // extern "C"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * @brief A batch of joystick events split into one column per field
+ *
+ * decode() keeps the button and axis events of a run of js_event records,
+ * with or without JS_EVENT_INIT, and drops the rest.  Records are split and
+ * filtered a group at a time with AVX2, SSE2 or NEON, whichever the build
+ * targets, and one at a time otherwise.
+ */
+template<std::size_t Capacity>
+class joystick_event_columns {
+public:
+    typedef std::size_t size_type;
+
+    joystick_event_columns() = default;
+    joystick_event_columns(const joystick_event_columns &) = default;
+    joystick_event_columns(joystick_event_columns &&) = default;
+    joystick_event_columns & operator=(const joystick_event_columns &) = default;
+    joystick_event_columns & operator=(joystick_event_columns &&) = default;
+    ~joystick_event_columns() = default;
+
+    /**
+     * @brief Append the kept events among the first count records, returning how many records were consumed
+     *
+     * No more records are consumed than there is room left for, so a caller
+     * decodes a longer run by clearing and decoding again.
+     */
+    size_type decode(const struct js_event * events, size_type count) {
+        count = std::min(count, Capacity - m_size);
+        size_type i = 0;
+#if defined(__AVX2__)
+        for (; i + 8 <= count; i += 8) {
+            decode8(events + i);
+        }
+#endif
+#if defined(__SSE2__) || defined(__ARM_NEON)
+        for (; i + 4 <= count; i += 4) {
+            decode4(events + i);
+        }
+#endif
+        for (; i != count; ++i) {
+            decode1(events[i]);
+        }
+        return count;
+    }
+
+    const std::uint32_t * times() const {
+        return m_times.data();
+    }
+
+    const std::int16_t * values() const {
+        return m_values.data();
+    }
+
+    const std::uint8_t * types() const {
+        return m_types.data();
+    }
+
+    const std::uint8_t * numbers() const {
+        return m_numbers.data();
+    }
+
+    bool empty() const {
+        return m_size == 0;
+    }
+
+    size_type size() const {
+        return m_size;
+    }
+
+    static constexpr size_type capacity() {
+        return Capacity;
+    }
+
+    void clear() {
+        m_size = 0;
+    }
+
+private:
+    static bool kept(std::uint8_t type) {
+        const std::uint8_t kind = type & ~JS_EVENT_INIT;
+        return kind == JS_EVENT_BUTTON || kind == JS_EVENT_AXIS;
+    }
+
+    void decode1(const struct js_event & event) {
+        // Written unconditionally and kept by advancing, so the loop does not branch on the type
+        m_times[m_size] = event.time;
+        m_values[m_size] = event.value;
+        m_types[m_size] = event.type;
+        m_numbers[m_size] = event.number;
+        m_size += kept(event.type);
+    }
+
+    /**
+     * @brief Drop the events of the group just stored at m_size that mask does not keep
+     */
+    void compact(unsigned mask, size_type group) {
+        size_type size = m_size;
+        for (size_type i = 0; i != group; ++i) {
+            m_times[size] = m_times[m_size + i];
+            m_values[size] = m_values[m_size + i];
+            m_types[size] = m_types[m_size + i];
+            m_numbers[size] = m_numbers[m_size + i];
+            size += (mask >> i) & 1;
+        }
+        m_size = size;
+    }
+
+#if defined(__AVX2__)
+    void decode8(const struct js_event * events) {
+        // Each record is a time dword then a dword of value, type and number; interleave the two halves of
+        // the group by dword, then restore record order across the lanes
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(events));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(events + 4));
+        const __m256i low = _mm256_unpacklo_epi32(a, b);
+        const __m256i high = _mm256_unpackhi_epi32(a, b);
+        const __m256i times = _mm256_permute4x64_epi64(_mm256_unpacklo_epi32(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+        const __m256i rest = _mm256_permute4x64_epi64(_mm256_unpackhi_epi32(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+
+        const __m256i values = _mm256_srai_epi32(_mm256_slli_epi32(rest, 16), 16);
+        const __m256i types = _mm256_and_si256(_mm256_srli_epi32(rest, 16), _mm256_set1_epi32(0xff));
+        const __m256i numbers = _mm256_srli_epi32(rest, 24);
+        const __m256i kinds = _mm256_and_si256(types, _mm256_set1_epi32(0xff & ~JS_EVENT_INIT));
+        const __m256i keep = _mm256_or_si256(
+            _mm256_cmpeq_epi32(kinds, _mm256_set1_epi32(JS_EVENT_BUTTON)),
+            _mm256_cmpeq_epi32(kinds, _mm256_set1_epi32(JS_EVENT_AXIS))
+        );
+        const unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(keep));
+        if (mask == 0) {
+            return;
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(m_times.data() + m_size), times);
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(m_values.data() + m_size),
+            _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1))
+        );
+        const __m128i bytes = _mm_packus_epi16(
+            _mm_packs_epi32(_mm256_castsi256_si128(types), _mm256_extracti128_si256(types, 1)),
+            _mm_packs_epi32(_mm256_castsi256_si128(numbers), _mm256_extracti128_si256(numbers, 1))
+        );
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(m_types.data() + m_size), bytes);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(m_numbers.data() + m_size), _mm_srli_si128(bytes, 8));
+        if (mask == 0xff) {
+            m_size += 8;
+        } else {
+            compact(mask, 8);
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    void decode4(const struct js_event * events) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(events));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(events + 2));
+        const __m128i low = _mm_unpacklo_epi32(a, b);
+        const __m128i high = _mm_unpackhi_epi32(a, b);
+        const __m128i times = _mm_unpacklo_epi32(low, high);
+        const __m128i rest = _mm_unpackhi_epi32(low, high);
+
+        const __m128i values = _mm_srai_epi32(_mm_slli_epi32(rest, 16), 16);
+        const __m128i types = _mm_and_si128(_mm_srli_epi32(rest, 16), _mm_set1_epi32(0xff));
+        const __m128i numbers = _mm_srli_epi32(rest, 24);
+        const __m128i kinds = _mm_and_si128(types, _mm_set1_epi32(0xff & ~JS_EVENT_INIT));
+        const __m128i keep = _mm_or_si128(
+            _mm_cmpeq_epi32(kinds, _mm_set1_epi32(JS_EVENT_BUTTON)),
+            _mm_cmpeq_epi32(kinds, _mm_set1_epi32(JS_EVENT_AXIS))
+        );
+        const unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(keep));
+        if (mask == 0) {
+            return;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(m_times.data() + m_size), times);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(m_values.data() + m_size), _mm_packs_epi32(values, values));
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(types, numbers), _mm_setzero_si128());
+        const std::uint32_t type_bytes = _mm_cvtsi128_si32(bytes);
+        const std::uint32_t number_bytes = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 4));
+        std::memcpy(m_types.data() + m_size, &type_bytes, 4);
+        std::memcpy(m_numbers.data() + m_size, &number_bytes, 4);
+        if (mask == 0xf) {
+            m_size += 4;
+        } else {
+            compact(mask, 4);
+        }
+    }
+#elif defined(__ARM_NEON)
+    void decode4(const struct js_event * events) {
+        // vld2 splits the time dwords from the dwords of value, type and number as it loads
+        const uint32x4x2_t records = vld2q_u32(reinterpret_cast<const std::uint32_t *>(events));
+        const uint32x4_t rest = records.val[1];
+
+        const uint32x4_t types = vandq_u32(vshrq_n_u32(rest, 16), vdupq_n_u32(0xff));
+        const uint32x4_t numbers = vshrq_n_u32(rest, 24);
+        const uint32x4_t kinds = vandq_u32(types, vdupq_n_u32(0xff & ~JS_EVENT_INIT));
+        const uint32x4_t keep = vorrq_u32(
+            vceqq_u32(kinds, vdupq_n_u32(JS_EVENT_BUTTON)),
+            vceqq_u32(kinds, vdupq_n_u32(JS_EVENT_AXIS))
+        );
+        const uint32x4_t bits = {1, 2, 4, 8};
+        const uint32x4_t selected = vandq_u32(keep, bits);
+        const uint32x2_t pairs = vorr_u32(vget_low_u32(selected), vget_high_u32(selected));
+        const unsigned mask = vget_lane_u32(pairs, 0) | vget_lane_u32(pairs, 1);
+        if (mask == 0) {
+            return;
+        }
+
+        vst1q_u32(m_times.data() + m_size, records.val[0]);
+        vst1_s16(m_values.data() + m_size, vreinterpret_s16_u16(vmovn_u32(rest)));
+        std::uint8_t bytes[8];
+        vst1_u8(bytes, vmovn_u16(vcombine_u16(vmovn_u32(types), vmovn_u32(numbers))));
+        std::memcpy(m_types.data() + m_size, bytes, 4);
+        std::memcpy(m_numbers.data() + m_size, bytes + 4, 4);
+        if (mask == 0xf) {
+            m_size += 4;
+        } else {
+            compact(mask, 4);
+        }
+    }
+#endif
+
+    alignas(32) std::array<std::uint32_t, Capacity> m_times;
+    alignas(32) std::array<std::int16_t, Capacity> m_values;
+    std::array<std::uint8_t, Capacity> m_types;
+    std::array<std::uint8_t, Capacity> m_numbers;
+    size_type m_size = 0;
+};
+
+#endif // JOYSTICK_EVENT_COLUMNS_HPP
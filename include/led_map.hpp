@@ -0,0 +1,186 @@
+#ifndef LED_MAP_HPP
+#define LED_MAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Input-to-LED bindings compiled into flat tables indexed by device class, event type and number
+ *
+ * Each binding holds the mask of LEDs an input drives when negative and when
+ * positive.  Buttons and GPIO lines only use the positive mask.  Bindings are
+ * read from lines of the form
+ *
+ *     <button|axis|gpio> <number|even|odd> <leds> [<leds>]
+ *
+ * where leds is a comma separated list of LED indices and ranges such as
+ * 0-4,10, or - for none.  Axes take the negative then the positive LEDs,
+ * buttons and GPIO offsets take one list.  Later lines override earlier
+ * ones, and # starts a comment.
+ */
+class led_map {
+public:
+    typedef std::uint32_t mask_type;
+
+    enum class class_type {
+        joystick,
+        gpio,
+    };
+
+    enum class event_type {
+        button,
+        axis,
+    };
+
+    struct binding_type {
+        mask_type negative = 0;
+        mask_type positive = 0;
+    };
+
+    static constexpr std::size_t s_numbers = 256;
+
+    led_map() = default;
+    led_map(const led_map &) = default;
+    led_map(led_map &&) = default;
+    led_map & operator=(const led_map &) = default;
+    led_map & operator=(led_map &&) = default;
+    ~led_map() = default;
+
+    const binding_type & find(class_type device, event_type type, std::size_t number) const {
+        static const binding_type s_unbound;
+        return number < s_numbers ?
+            m_bindings[static_cast<std::size_t>(device)][static_cast<std::size_t>(type)][number] :
+            s_unbound;
+    }
+
+    /**
+     * @brief Compile the bindings of a stream, throwing std::runtime_error naming the origin and line of any error
+     */
+    static led_map parse(std::istream & stream, std::size_t leds, std::string_view origin) {
+        led_map map;
+        std::string line;
+        for (std::size_t number = 1; std::getline(stream, line); ++number) {
+            try {
+                map.parse_line(std::string_view(line).substr(0, line.find('#')), leds);
+            } catch (const std::invalid_argument & error) {
+                std::ostringstream message;
+                message << origin << ':' << number << ": " << error.what();
+                throw std::runtime_error(message.str());
+            }
+        }
+        return map;
+    }
+
+    static led_map parse(std::string_view text, std::size_t leds, std::string_view origin) {
+        std::istringstream stream{std::string(text)};
+        return parse(stream, leds, origin);
+    }
+
+    static led_map load(const std::string & path, std::size_t leds) {
+        std::ifstream stream(path);
+        if (!stream) {
+            throw std::runtime_error(path + ": cannot open");
+        }
+        return parse(stream, leds, path);
+    }
+
+private:
+    static std::string_view token(std::string_view & line) {
+        const std::size_t begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string_view::npos) {
+            line = std::string_view();
+            return line;
+        }
+        line.remove_prefix(begin);
+        const std::size_t end = std::min(line.find_first_of(" \t\r"), line.size());
+        const std::string_view result = line.substr(0, end);
+        line.remove_prefix(end);
+        return result;
+    }
+
+    static std::size_t number(std::string_view text, std::size_t limit) {
+        std::size_t value;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size() || value >= limit) {
+            throw std::invalid_argument("invalid number \"" + std::string(text) + "\"");
+        }
+        return value;
+    }
+
+    static mask_type mask(std::string_view text, std::size_t leds) {
+        if (text.empty()) {
+            throw std::invalid_argument("missing LEDs");
+        } else if (text == "-") {
+            return 0;
+        }
+        mask_type mask = 0;
+        while (!text.empty()) {
+            const std::string_view item = text.substr(0, text.find(','));
+            text.remove_prefix(std::min(item.size() + 1, text.size()));
+            const std::size_t dash = item.find('-');
+            const std::size_t first = number(item.substr(0, dash), leds);
+            const std::size_t last = dash == std::string_view::npos ? first : number(item.substr(dash + 1), leds);
+            for (std::size_t led = first; led <= last; ++led) {
+                mask |= mask_type(1) << led;
+            }
+        }
+        return mask;
+    }
+
+    void parse_line(std::string_view line, std::size_t leds) {
+        if (leds > sizeof(mask_type) * 8) {
+            throw std::invalid_argument("too many LEDs for a mask");
+        }
+        const std::string_view kind = token(line);
+        if (kind.empty()) {
+            return;
+        }
+        class_type device = class_type::joystick;
+        event_type type = event_type::button;
+        if (kind == "axis") {
+            type = event_type::axis;
+        } else if (kind == "gpio") {
+            device = class_type::gpio;
+        } else if (kind != "button") {
+            throw std::invalid_argument("unknown input \"" + std::string(kind) + "\"");
+        }
+
+        const std::string_view selector = token(line);
+        std::size_t first = 0;
+        std::size_t step = 2;
+        if (selector == "even") {
+            first = 0;
+        } else if (selector == "odd") {
+            first = 1;
+        } else {
+            first = number(selector, s_numbers);
+            step = s_numbers;
+        }
+
+        binding_type binding;
+        if (type == event_type::axis) {
+            binding.negative = mask(token(line), leds);
+        }
+        binding.positive = mask(token(line), leds);
+        if (!token(line).empty()) {
+            throw std::invalid_argument("trailing characters");
+        }
+
+        for (std::size_t i = first; i < s_numbers; i += step) {
+            m_bindings[static_cast<std::size_t>(device)][static_cast<std::size_t>(type)][i] = binding;
+        }
+    }
+
+    std::array<std::array<std::array<binding_type, s_numbers>, 2>, 2> m_bindings{};
+};
+
+#endif // LED_MAP_HPP
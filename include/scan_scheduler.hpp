@@ -0,0 +1,135 @@
+#ifndef SCAN_SCHEDULER_HPP
+#define SCAN_SCHEDULER_HPP
+
+extern "C" {
+#include <time.h>
+} // extern "C"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+
+#include <asio/steady_timer.hpp>
+
+/**
+ * @brief Paces a scan loop on absolute deadlines of a fixed period
+ *
+ * Each wait expires at the previous deadline plus one period, so handler
+ * latency does not accumulate as drift.  When the loop falls behind by more
+ * than a period, the missed slots are skipped rather than replayed in a burst.
+ * A wait may span any fraction or multiple of a period, which lets binary
+ * code modulation hold each bit-plane for a time proportional to its weight.
+ *
+ * Slots can be awaited on the io_context through async_wait(), or on a
+ * dedicated thread through wait(), which sleeps with clock_nanosleep() on
+ * the same CLOCK_MONOTONIC deadlines that back std::chrono::steady_clock.
+ */
+class scan_scheduler {
+public:
+    typedef std::chrono::steady_clock clock_type;
+    typedef clock_type::duration duration;
+    typedef clock_type::time_point time_point;
+    typedef std::uint64_t count_type;
+
+    struct statistics_type {
+        double rate;
+        double frame_rate;
+        count_type slots;
+        count_type missed;
+    };
+
+    scan_scheduler() = delete;
+    scan_scheduler(asio::io_context & io_context, duration period) :
+        m_timer(io_context),
+        m_period(period)
+    {}
+    scan_scheduler(const scan_scheduler &) = delete;
+    scan_scheduler(scan_scheduler &&) = delete;
+    scan_scheduler & operator=(const scan_scheduler &) = delete;
+    scan_scheduler & operator=(scan_scheduler &&) = delete;
+    ~scan_scheduler() = default;
+
+    duration period() const {
+        return m_period;
+    }
+
+    void start() {
+        m_deadline = clock_type::now();
+        m_window = m_deadline;
+        m_slots = 0;
+        m_frames = 0;
+        m_missed = 0;
+    }
+
+    template<typename WaitHandler>
+    void async_wait(duration span, WaitHandler && handler) {
+        advance(span);
+        m_timer.expires_at(m_deadline);
+        m_timer.async_wait(std::forward<WaitHandler>(handler));
+    }
+
+    void wait(duration span) {
+        advance(span);
+        const std::chrono::nanoseconds deadline = m_deadline.time_since_epoch();
+        struct timespec time;
+        time.tv_sec = std::chrono::duration_cast<std::chrono::seconds>(deadline).count();
+        time.tv_nsec = (deadline % std::chrono::seconds(1)).count();
+        while (::clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &time, nullptr) == EINTR) {}
+    }
+
+    void cancel() {
+        m_timer.cancel();
+    }
+
+    void tick() {
+        ++m_slots;
+    }
+
+    void frame() {
+        ++m_frames;
+    }
+
+    duration elapsed() const {
+        return m_deadline - m_window;
+    }
+
+    /**
+     * @brief Report the slot rate achieved since the previous sample and start a new window
+     */
+    statistics_type sample() {
+        const time_point now = clock_type::now();
+        const std::chrono::duration<double> window = now - m_window;
+        const statistics_type statistics{
+            window.count() > 0 ? m_slots / window.count() : 0,
+            window.count() > 0 ? m_frames / window.count() : 0,
+            m_slots,
+            m_missed
+        };
+        m_window = now;
+        m_slots = 0;
+        m_frames = 0;
+        m_missed = 0;
+        return statistics;
+    }
+
+private:
+    void advance(duration span) {
+        m_deadline += span;
+        const time_point now = clock_type::now();
+        if (m_deadline < now) {
+            const auto missed = (now - m_deadline) / m_period;
+            m_deadline += m_period * missed;
+            m_missed += missed;
+        }
+    }
+
+    asio::steady_timer m_timer;
+    duration m_period;
+    time_point m_deadline;
+    time_point m_window;
+    count_type m_slots = 0;
+    count_type m_frames = 0;
+    count_type m_missed = 0;
+};
+
+#endif // SCAN_SCHEDULER_HPP
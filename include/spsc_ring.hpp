@@ -0,0 +1,61 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Bounded wait-free queue between exactly one producer and one consumer thread
+ *
+ * The producer only writes the tail and the consumer only writes the head,
+ * each on its own cache line.  push() fails rather than waits when full.
+ */
+template<typename T, std::size_t Capacity>
+class spsc_ring {
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+    spsc_ring() = default;
+    spsc_ring(const spsc_ring &) = delete;
+    spsc_ring(spsc_ring &&) = delete;
+    spsc_ring & operator=(const spsc_ring &) = delete;
+    spsc_ring & operator=(spsc_ring &&) = delete;
+    ~spsc_ring() = default;
+
+    bool push(const value_type & value) {
+        const size_type tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        m_values[tail & s_mask] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(value_type & value) {
+        const size_type head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = m_values[head & s_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    static constexpr size_type capacity() {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_type s_mask = Capacity - 1;
+
+    alignas(64) std::atomic<size_type> m_head{0};
+    alignas(64) std::atomic<size_type> m_tail{0};
+    alignas(64) std::array<value_type, Capacity> m_values;
+};
+
+#endif // SPSC_RING_HPP
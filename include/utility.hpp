@@ -1,16 +1,34 @@
 #ifndef FUNCTIONAL_HPP
 #define FUNCTIONAL_HPP
 
+#include <cstdint>
 #include <functional>
 #include <utility>
 
+namespace detail {
+
+/**
+ * @brief Combine two hashes through the splitmix64 finalizer, so equal or related halves do not cancel out
+ */
+inline std::size_t hash_combine(std::size_t lhs, std::size_t rhs) {
+    std::uint64_t value = (std::uint64_t(lhs) * 0x9e3779b97f4a7c15ull) ^ rhs;
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    value ^= value >> 31;
+    return static_cast<std::size_t>(value);
+}
+
+} // namespace detail
+
 namespace std {
 
 template<typename T>
 struct hash<std::pair<T,T>> : private std::hash<T> {
     std::size_t operator()(const std::pair<T,T> & value) const {
-        return (
-            std::hash<T>::operator()(value.first) ^
+        return detail::hash_combine(
+            std::hash<T>::operator()(value.first),
             std::hash<T>::operator()(value.second)
         );
     }
@@ -19,8 +37,8 @@ struct hash<std::pair<T,T>> : private std::hash<T> {
 template<typename T, typename U>
 struct hash<std::pair<T,U>> : private std::hash<T>, private std::hash<U> {
     std::size_t operator()(const std::pair<T,U> & value) const {
-        return (
-            std::hash<T>::operator()(value.first) ^
+        return detail::hash_combine(
+            std::hash<T>::operator()(value.first),
             std::hash<U>::operator()(value.second)
         );
     }
@@ -0,0 +1,89 @@
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+namespace {
+
+void * allocate(std::size_t size) {
+    allocation_counter::record();
+    if (void * const pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void * allocate(std::size_t size, std::align_val_t alignment) {
+    allocation_counter::record();
+    const std::size_t align = static_cast<std::size_t>(alignment);
+    if (void * const pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+void * operator new(std::size_t size) {
+    return allocate(size);
+}
+
+void * operator new[](std::size_t size) {
+    return allocate(size);
+}
+
+void * operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return allocate(size);
+    } catch (const std::bad_alloc &) {
+        return nullptr;
+    }
+}
+
+void * operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, alignment);
+}
+
+void * operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, alignment);
+}
+
+void operator delete(void * pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void * pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void * pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void * pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
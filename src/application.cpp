@@ -1,85 +1,295 @@
 #include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <regex>
+#include <string>
 #include <thread>
-
-#include <asio/post.hpp>
+#include <vector>
 
 #include "application.hpp"
 
 constexpr const std::array<std::uint32_t, 4> Application::s_inputs({17, 22, 23, 27});
 constexpr const std::array<std::uint32_t, 5> Application::s_outputs({13, 19, 26, 20, 21});
 constexpr const std::array<std::uint32_t, 1> Application::s_brightness({18});
+constexpr const std::chrono::seconds Application::s_report_period(10);
+constexpr const std::string_view Application::s_default_map(
+    "button 0 5\n"
+    "button 1 10\n"
+    "button 3 0\n"
+    "button 4 15\n"
+    "axis odd 0-4 10-14\n"
+    "axis even 15-19 5-9\n"
+);
+
+constexpr const std::array<charlie_type, 20> Application::s_charlies({{
+    {0, 1},
+    {0, 2},
+    {0, 3},
+    {0, 4},
+    {1, 2},
+
+    {1, 0},
+    {2, 0},
+    {3, 0},
+    {4, 0},
+    {2, 1},
+
+    {1, 3},
+    {1, 4},
+    {2, 3},
+    {2, 4},
+    {3, 4},
+
+    {3, 1},
+    {4, 1},
+    {3, 2},
+    {4, 2},
+    {4, 3},
+}});
+constexpr const std::array<std::uint8_t, 256> Application::s_gamma({{
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
+    6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+    20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+    30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+    42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+    73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+    91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+}});
+constexpr const std::array<struct gpio_v2_line_config, 20> Application::s_slots(make_charlie_slot_table(s_charlies));
+constexpr const std::array<std::array<struct gpio_v2_line_config, (1 << 5)>, 5> Application::s_rows(make_charlie_row_table<5>());
+constexpr const struct gpio_v2_line_config Application::s_idle(make_charlie_idle_config());
+
+namespace {
+
+void print(std::ostream & stream, std::string_view name, const concurrent_histogram & histogram) {
+    const std::unique_ptr<const ::histogram> merged = histogram.merged();
+    stream << ' '
+        << name << ": "
+        << "count: " << merged->count() << ", "
+        << "p50: " << merged->percentile(0.5) << "ns, "
+        << "p99: " << merged->percentile(0.99) << "ns, "
+        << "p99.9: " << merged->percentile(0.999) << "ns, "
+        << "max: " << merged->max() << "ns" << '\n';
+}
+
+bool is_device(std::string_view prefix, std::string_view name) {
+    return (
+        name.size() > prefix.size() &&
+        name.substr(0, prefix.size()) == prefix &&
+        std::all_of(name.begin() + prefix.size(), name.end(), [](char c){
+            return c >= '0' && c <= '9';
+        })
+    );
+}
+
+event_logger::level_type log_level(Arguments::level_type level) {
+    switch (level) {
+    case Arguments::level_type::none:
+        return event_logger::level_type::none;
+    case Arguments::level_type::info:
+        return event_logger::level_type::info;
+    case Arguments::level_type::event:
+    default:
+        return event_logger::level_type::event;
+    }
+}
+
+std::string_view device_prefix(Arguments::input_type input) {
+    using namespace std::literals;
+
+    return input == Arguments::input_type::evdev ? "event"sv : "js"sv;
+}
 
-void Application::enable(charlie_type charlie) {
-    struct gpio_v2_line_config output_line_config;
-    std::memset(&output_line_config, 0, sizeof(output_line_config));
-    output_line_config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
-    output_line_config.num_attrs = 1;
-    output_line_config.attrs[0].mask = mask_type().set().set(charlie.first, false).set(charlie.second, false).to_ullong();
-    output_line_config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
-    output_line_config.attrs[0].attr.flags = GPIO_V2_LINE_FLAG_INPUT;
-    m_output.set_config(output_line_config);
+std::string device_path(std::string_view name) {
+    using namespace std::literals;
+    static constexpr const std::string_view input = "/dev/input/"sv;
 
-    struct gpio_v2_line_values output_line_values;
-    std::memset(&output_line_values, 0, sizeof(output_line_values));
-    output_line_values.bits = mask_type().set(charlie.first, true).set(charlie.second, false).to_ullong();
-    output_line_values.mask = mask_type().set(charlie.first).set(charlie.second).to_ullong();
-    m_output.set_values(output_line_values);
+    std::string path;
+    path.reserve(input.size() + name.size());
+    path.append(input).append(name);
+    return path;
+}
+
+/**
+ * @brief The whole records of type T in a capture entry, leaving out a truncated one at the end
+ */
+template<typename T>
+asio::mutable_buffers_1 whole_records(const capture_reader::entry_type & entry) {
+    return asio::mutable_buffers_1(entry.data, entry.size - entry.size % sizeof(T));
+}
+
+/**
+ * @brief Scale an absolute axis value to the joydev range, treating the flat zone around its center as zero
+ */
+std::int16_t normalize(std::int32_t value, const struct input_absinfo & absinfo) {
+    const std::int64_t range = std::int64_t(absinfo.maximum) - absinfo.minimum;
+    if (range <= 0) {
+        return 0;
+    }
+    const std::int64_t offset = 2 * (std::int64_t(value) - absinfo.minimum) - range;
+    if (std::abs(offset) <= 2 * std::int64_t(absinfo.flat)) {
+        return 0;
+    }
+    return static_cast<std::int16_t>(std::clamp<std::int64_t>(offset * 0x7fff / range, -0x7fff, 0x7fff));
+}
+
+std::uint64_t monotonic_now() {
+    return std::chrono::nanoseconds(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+std::uint64_t nanoseconds(const struct input_event & event) {
+    return std::uint64_t(event.input_event_sec) * 1000000000 + std::uint64_t(event.input_event_usec) * 1000;
+}
+
+std::uint32_t milliseconds(const struct input_event & event) {
+    return static_cast<std::uint32_t>(std::uint64_t(event.input_event_sec) * 1000 + event.input_event_usec / 1000);
+}
+
+} // namespace
+
+led_map Application::load_map(const Arguments & arguments) {
+    try {
+        return arguments.map ?
+            led_map::load(std::string(*arguments.map), std::tuple_size_v<frame_type>) :
+            led_map::parse(s_default_map, std::tuple_size_v<frame_type>, "default map");
+    } catch (const std::runtime_error & error) {
+        std::cerr << "invalid map: " << error.what() << ", aborting" << std::endl;
+        std::quick_exit(EXIT_FAILURE);
+    }
+}
+
+void Application::light(frame_type & leds, led_map::mask_type mask, std::uint8_t level, source_type source, std::uint64_t stamp) const {
+    // Only a changed level is traced, so the scanner measures the input that actually altered the LED
+    for (; mask; mask &= mask - 1) {
+        led_type & led = leds[__builtin_ctz(mask)];
+        if (led.level != level) {
+            led.level = level;
+            led.source = stamp ? source : source_type::none;
+            led.stamp = stamp;
+        }
+    }
+}
+
+void Application::enable(const struct gpio_v2_line_config & config) {
+    m_lines.set_config(config);
 }
 
 void Application::disable() {
-    struct gpio_v2_line_config output_line_config;
-    std::memset(&output_line_config, 0, sizeof(output_line_config));
-    output_line_config.flags = GPIO_V2_LINE_FLAG_INPUT;
-    output_line_config.num_attrs = 0;
-    m_output.set_config(output_line_config);
+    m_lines.set_config(s_idle);
+}
+
+template<typename Descriptor>
+void Application::attach(Descriptor & descriptor, std::string_view name) {
+    if (m_ring.is_open()) {
+        // A descriptor that cannot be made non-blocking keeps reading through the reactor
+        asio::error_code ec;
+        descriptor.attach(m_ring, ec);
+        if (ec) {
+            std::cout << "io_uring: " << name << " not attached (" << ec.message() << "), reading through epoll" << std::endl;
+        }
+    }
+}
+
+template<typename Results>
+void Application::capture(capture_format::kind_type kind, std::uint32_t device, const Results & results) {
+    const std::size_t size = results.end().base() - results.begin().base();
+    if (size) {
+        capture(kind, device, &*results.begin().base(), size);
+    }
+}
+
+void Application::capture(capture_format::kind_type kind, std::uint32_t device, const void * data, std::size_t size) {
+    if (m_recorder.is_open()) {
+        asio::error_code ec;
+        m_recorder.append(kind, device, monotonic_now(), data, size, ec);
+        if (ec) {
+            std::cout << "record: " << ec.message() << ", stopping" << std::endl;
+            m_recorder.close();
+        }
+    }
 }
 
 Application::Application(asio::io_context & context, const Arguments & arguments) :
     m_context(context),
+    m_logger(log_level(arguments.log_level)),
+    m_registry(asio::make_strand(context)),
+    m_gpio(asio::make_strand(context)),
+    m_signals(context, SIGUSR1),
     m_inotify(context),
+    m_input_type(arguments.input),
+    m_map(load_map(arguments)),
+    m_replay_pace(arguments.replay_pace),
+    m_replay_timer(context),
+    m_threads(arguments.io_threads()),
     m_chip(context),
     m_input(context),
     m_output(context),
+    m_lines(m_output),
+    m_debounce_timer(context),
+    m_ring(context),
     //m_pwm(context),
     //m_mark({std::chrono::microseconds(1000), std::chrono::microseconds(0)}),
-    m_leds({
-        led_type({{0, 1}}),
-        led_type({{0, 2}}),
-        led_type({{0, 3}}),
-        led_type({{0, 4}}),
-        led_type({{1, 2}}),
-
-        led_type({{1, 0}}),
-        led_type({{2, 0}}),
-        led_type({{3, 0}}),
-        led_type({{4, 0}}),
-        led_type({{2, 1}}),
-
-        led_type({{1, 3}}),
-        led_type({{1, 4}}),
-        led_type({{2, 3}}),
-        led_type({{2, 4}}),
-        led_type({{3, 4}}),
-
-        led_type({{3, 1}}),
-        led_type({{4, 1}}),
-        led_type({{3, 2}}),
-        led_type({{4, 2}}),
-        led_type({{4, 3}}),
-    })
+    m_scan(arguments.scan),
+    m_steps(m_scan == Arguments::scan_type::row ? s_outputs.size() : s_charlies.size()),
+    m_scheduler(context, std::chrono::nanoseconds(std::chrono::seconds(1)) / arguments.rate)
 {
-    m_inotify.assign(::inotify_init());
-    m_inotify.add_watch("/dev/input", IN_CREATE | IN_ONLYDIR | IN_ATTRIB);
-    resync();
-    async_read_inotify_events(std::make_shared<asio::streambuf>());
+    async_wait_report();
+
+    if (arguments.io_uring) {
+        asio::error_code ec;
+        m_ring.open(io_ring::s_entries, ec);
+        if (ec) {
+            std::cout << "io_uring: unavailable (" << ec.message() << "), reading through epoll" << std::endl;
+        } else {
+            // Each table slot reads into its own buffer, registered once for the life of the ring
+            std::array<asio::mutable_buffer, s_devices + 2> buffers;
+            for (std::size_t i = 0; i != s_devices; ++i) {
+                buffers[i] = m_input_type == Arguments::input_type::evdev ?
+                    asio::buffer(m_evdev_buffers[i]) :
+                    asio::buffer(m_joystick_buffers[i]);
+            }
+            buffers[s_devices] = asio::buffer(m_inotify_buffer);
+            buffers[s_devices + 1] = asio::buffer(m_gpio_buffer);
+            m_ring.register_buffers(buffers, ec);
+            if (ec) {
+                std::cout << "io_uring: buffers not registered (" << ec.message() << "), reading without them" << std::endl;
+            }
+        }
+    }
+
+    if (arguments.record) {
+        m_recorder.open(std::string(*arguments.record));
+    }
+    if (arguments.replay) {
+        // Replayed reads stand in for the input devices, so they are neither probed nor watched
+        m_replayer.open(std::string(*arguments.replay));
+        asio::post(m_registry, [this](){
+            async_replay();
+        });
+    } else {
+        m_inotify.assign(::inotify_init());
+        m_inotify.add_watch("/dev/input", IN_CREATE | IN_DELETE | IN_ONLYDIR | IN_ATTRIB);
+        attach(m_inotify, "inotify");
+        resync();
+        async_read_inotify_events();
+    }
 
     const int chip_fd = ::open("/dev/gpiochip0", O_RDONLY);
-    if (chip_fd) {
+    if (chip_fd != -1) {
         m_chip.assign(chip_fd);
 
         const std::string_view consumer(arguments.name.substr(0, GPIO_MAX_NAME_SIZE - 1));
@@ -96,11 +306,31 @@ Application::Application(asio::io_context & context, const Arguments & arguments
             GPIO_V2_LINE_FLAG_BIAS_PULL_UP
         );
         input_line_request.config.num_attrs = 0;
+        if (arguments.debounce) {
+            struct gpio_v2_line_config_attribute & debounce = input_line_request.config.attrs[input_line_request.config.num_attrs++];
+            debounce.attr.id = GPIO_V2_LINE_ATTR_ID_DEBOUNCE;
+            debounce.attr.debounce_period_us = arguments.debounce;
+            debounce.mask = (std::uint64_t(1) << s_inputs.size()) - 1;
+        }
         input_line_request.num_lines = s_inputs.size();
-        input_line_request.event_buffer_size = 0;
-        m_chip.get_line(input_line_request);
+        input_line_request.event_buffer_size = arguments.gpio_events;
+        asio::error_code ec;
+        m_chip.get_line(input_line_request, ec);
+        if (
+            input_line_request.config.num_attrs &&
+            (ec == asio::error::invalid_argument || ec == asio::error::operation_not_supported)
+        ) {
+            // Kernels or chips without debounce support reject the attribute, so filter edges here instead
+            std::cout << "gpio: debounce unavailable (" << ec.message() << "), debouncing in userspace" << std::endl;
+            input_line_request.config.num_attrs = 0;
+            m_debouncer.period(std::chrono::microseconds(arguments.debounce));
+            m_chip.get_line(input_line_request);
+        } else if (ec) {
+            throw asio::system_error(ec);
+        }
         m_input.assign(input_line_request.fd);
-        async_read_gpio_line_events(m_input, std::make_shared<asio::streambuf>());
+        attach(m_input, "gpio");
+        async_read_gpio_line_events(m_input);
 
         struct gpio_v2_line_request output_line_request;
         std::memset(&output_line_request, 0, sizeof(output_line_request));
@@ -132,9 +362,16 @@ Application::Application(asio::io_context & context, const Arguments & arguments
         m_pwm.assign(brightness_line_request.fd);
         */
 
-        asio::post(m_context, [this](){
-            update();
-        });
+        m_scheduler.start();
+        m_frame_start = scan_scheduler::clock_type::now();
+        if (arguments.scan_thread) {
+            m_scanning = true;
+            m_scanner = std::thread([this,cpu=arguments.scan_cpu,priority=arguments.scan_priority](){
+                scan(cpu, priority);
+            });
+        } else {
+            async_update();
+        }
 
         /*
         asio::post(m_context, [this](){
@@ -142,224 +379,436 @@ Application::Application(asio::io_context & context, const Arguments & arguments
         });
         */
     }
+
+#if defined(TRAFFIC_COUNT_ALLOCATIONS)
+    allocation_counter::arm();
+#endif
 }
 
-void Application::async_read_inotify_events(
-    const std::shared_ptr<asio::streambuf> & buffer
-) {
-    m_inotify.async_read_events(
-        asio::buffer(buffer->prepare(sizeof(struct inotify_event) + NAME_MAX + 1)),
-        [this,buffer](const asio::error_code & error, const inotify_event_results<asio::mutable_buffers_1> & results){
-            handle_inotify_events(buffer, error, results);
+Application::~Application() {
+    if (m_scanner.joinable()) {
+        m_scanning = false;
+        m_scanner.join();
+    }
+
+    // Handlers still queued or in flight live in, and were allocated from, this object, so they are run out
+    // here with every wait aborted rather than destroyed with the io_context once this object is gone
+    m_closing = true;
+    m_ring.close();
+    asio::error_code ec;
+    m_signals.cancel(ec);
+    m_replay_timer.cancel();
+    m_debounce_timer.cancel();
+    m_scheduler.cancel();
+    m_inotify.close(ec);
+    m_input.close(ec);
+    for (const auto & [name, handle] : m_devices) {
+        if (m_input_type == Arguments::input_type::evdev) {
+            if (evdev_type * const evdev = m_evdevs.get(handle)) {
+                evdev->descriptor.close(ec);
+            }
+        } else if (joystick_type * const joystick = m_joysticks.get(handle)) {
+            joystick->descriptor.close(ec);
         }
+    }
+    m_context.restart();
+    m_context.poll();
+}
+
+void Application::report(std::ostream & stream) const {
+    print(stream, "scan.frame", m_frame_time);
+    print(stream, "scan.step", m_step_time);
+    print(stream, "gpio.set_config", m_lines.config_latency());
+    print(stream, "gpio.set_values", m_lines.values_latency());
+    print(stream, "latency.gpio", m_latency[static_cast<std::size_t>(source_type::gpio)]);
+    print(stream, "latency.joydev", m_latency[static_cast<std::size_t>(source_type::joydev)]);
+    print(stream, "latency.evdev", m_latency[static_cast<std::size_t>(source_type::evdev)]);
+    stream << ' '
+        << "gpio.debounce: "
+        << "period: " << m_debouncer.period().count() << "ns, "
+        << "rejected: " << m_debouncer.rejected() << '\n';
+    if (m_ring.is_open()) {
+        stream << ' '
+            << "io_uring: "
+            << "reads: " << m_ring.reads() << ", "
+            << "fixed: " << m_ring.fixed_reads() << ", "
+            << "submits: " << m_ring.submits() << ", "
+            << "wakeups: " << m_ring.wakeups() << '\n';
+    }
+#if defined(TRAFFIC_COUNT_ALLOCATIONS)
+    stream << ' '
+        << "allocations: " << allocation_counter::count() << '\n';
+#endif
+    stream << ' '
+        << "log: "
+        << "dropped: " << m_logger.dropped() << '\n';
+    stream << ' '
+        << "gpio.events: "
+        << "count: " << m_sequence.events() << ", "
+        << "dropped: " << m_sequence.dropped() << ", "
+        << "rate: " << m_sequence.rate() << "/s, "
+        << "largest gap: " << m_sequence.largest_gap();
+    for (const std::uint32_t offset : s_inputs) {
+        stream << ", " << "line " << offset << ": " << m_sequence.dropped(offset);
+    }
+    stream << '\n';
+    stream << std::flush;
+}
+
+void Application::async_wait_report() {
+    // The report reads the GPIO input counters, so it runs on their strand
+    m_signals.async_wait(asio::bind_executor(m_gpio, [this](const asio::error_code & error, int){
+        if (!error) {
+            report(std::cout);
+            async_wait_report();
+        }
+    }));
+}
+
+void Application::async_read_inotify_events() {
+    m_inotify.async_read_events(
+        asio::buffer(m_inotify_buffer),
+        asio::bind_executor(m_registry, make_custom_alloc_handler(m_inotify_memory, [this](const asio::error_code & error, const inotify_event_results<asio::mutable_buffers_1> & results){
+            handle_inotify_events(error, results);
+        }))
     );
 }
 
 void Application::handle_inotify_events(
-    const std::shared_ptr<asio::streambuf> & buffer,
     const asio::error_code & error,
     const inotify_event_results<asio::mutable_buffers_1> & results
 ) {
     if (!error) {
-        for (auto event = results.begin(); event != results.end(); ++event) {
-            if (event->mask & IN_Q_OVERFLOW) {
-                resync();
-            } else if (event->mask & IN_IGNORED) {
-                m_context.stop();
-            } else {
-                insert(event->name);
-            }
-        }
-        buffer->consume(sizeof(struct inotify_event) + NAME_MAX + 1);
-        async_read_inotify_events(buffer);
+        // The kernel only returns whole events, so each read is processed in full and nothing carries over
+        process_inotify_events(results);
+        async_read_inotify_events();
     } else if (error != asio::error::operation_aborted) {
         m_context.stop();
     }
 }
 
-void Application::async_read_joystick_events(
-    const std::shared_ptr<joystick_type> & joystick,
-    const std::shared_ptr<asio::streambuf> & buffer
+template<typename BufferSequence>
+void Application::process_inotify_events(
+    const inotify_event_results<BufferSequence> & events
 ) {
-    joystick->descriptor.async_read_events(
-        asio::buffer(buffer->prepare(sizeof(struct js_event))),
-        [this,joystick,buffer](const asio::error_code & error, const joystick_event_results<asio::mutable_buffers_1> & results){
-            handle_joystick_events(joystick, buffer, error, results);
+    if (m_replayer.is_open()) {
+        return;
+    }
+    for (auto event = events.begin(); event != events.end(); ++event) {
+        if (event->mask & IN_Q_OVERFLOW) {
+            resync();
+        } else if (event->mask & IN_IGNORED) {
+            m_context.stop();
+        } else if (event->mask & IN_DELETE) {
+            remove(event->name);
+        } else {
+            insert(event->name);
         }
+    }
+}
+
+void Application::async_read_joystick_events(
+    device_handle handle,
+    joystick_type & joystick
+) {
+    joystick.descriptor.async_read_events(
+        asio::buffer(m_joystick_buffers[handle.index]),
+        asio::bind_executor(joystick.strand, make_custom_alloc_handler(joystick.memory, [this,handle](const asio::error_code & error, const joystick_event_results<asio::mutable_buffers_1> & results){
+            handle_joystick_events(handle, error, results);
+        }))
     );
 }
 
 void Application::handle_joystick_events(
-    const std::shared_ptr<joystick_type> & joystick,
-    const std::shared_ptr<asio::streambuf> & buffer,
+    device_handle handle,
     const asio::error_code & error,
     const joystick_event_results<asio::mutable_buffers_1> & results
 ) {
+    joystick_type * const joystick = m_joysticks.get(handle);
+    if (!joystick) {
+        return;
+    }
     if (!error) {
-        for(auto event = results.begin(); event != results.end(); ++event) {
-            switch(event->type) {
-            case JS_EVENT_INIT:
-                std::cout << ' '
-                    << "joystick: " << joystick.get() << ", "
-                    << "init: " << static_cast<unsigned>(event->number) << ", "
-                    << "value: " << static_cast<int>(event->value) << ", "
-                    << "time: " << event->time << "ms" << std::endl;
-                break;
-            case JS_EVENT_BUTTON:
-                std::cout << ' '
-                    << "joystick: " << joystick.get() << ", "
-                    << "button: " << static_cast<unsigned>(event->number) << ", "
-                    << "value: " << static_cast<int>(event->value) << ", "
-                    << "time: " << event->time << "ms" << std::endl;
-                    if (event->number == 0) {
-                        m_leds[5].state = event->value;
-                    } else if (event->number == 1) {
-                        m_leds[10].state = event->value;
-                    } else if (event->number == 3) {
-                        m_leds[0].state = event->value;
-                    } else if (event->number == 4) {
-                        m_leds[15].state = event->value;
-                    }
-                break;
-            case JS_EVENT_AXIS:
-                std::cout << ' '
-                    << "joystick: " << joystick.get() << ", "
-                    << "axis: " << static_cast<unsigned>(event->number) << ", "
-                    << "value: " << static_cast<int>(event->value) << ", "
-                    << "time: " << event->time << "ms" << std::endl;
-                if (m_chip.is_open()) {
-                    if (event->number & 1) {
-                        for (decltype(m_leds)::size_type i = 0; i != 5; ++i) {
-                            m_leds[i].state = event->value < 0;
-                        }
-                        for (decltype(m_leds)::size_type i = 10; i != 15; ++i) {
-                            m_leds[i].state = event->value > 0;
-                        }
-                    } else {
-                        for (decltype(m_leds)::size_type i = 5; i != 10; ++i) {
-                            m_leds[i].state = event->value > 0;
-                        }
-                        for (decltype(m_leds)::size_type i = 15; i != 20; ++i) {
-                            m_leds[i].state = event->value < 0;
-                        }
-                    }
+        capture(capture_format::kind_type::joystick, handle.index, results);
+        process_joystick_events(handle, *joystick, results);
+        async_read_joystick_events(handle, *joystick);
+    } else {
+        finish(m_joysticks, handle, *joystick);
+    }
+}
+
+void Application::process_joystick_events(
+    device_handle handle,
+    joystick_type & joystick,
+    const joystick_event_results<asio::mutable_buffers_1> & results
+) {
+    const std::uint64_t now = monotonic_now();
+    // Split the records into columns first, so coalescing runs over them without dispatching on each record
+    joystick_event_columns<s_joystick_batch> columns;
+    const struct js_event * event = results.data();
+    const struct js_event * const end = event + results.size();
+    while (event != end) {
+        columns.clear();
+        event += columns.decode(event, end - event);
+        joystick.events.insert(columns, [&joystick,now](std::uint32_t time, std::uint8_t type){
+            return type & JS_EVENT_INIT ? 0 : joystick.clock.monotonic(time, now);
+        });
+    }
+    publish(handle, joystick.events, source_type::joydev);
+}
+
+void Application::async_read_evdev_events(
+    device_handle handle,
+    evdev_type & evdev
+) {
+    evdev.descriptor.async_read_events(
+        asio::buffer(m_evdev_buffers[handle.index]),
+        asio::bind_executor(evdev.strand, make_custom_alloc_handler(evdev.memory, [this,handle](const asio::error_code & error, const evdev_event_results<asio::mutable_buffers_1> & results){
+            handle_evdev_events(handle, error, results);
+        }))
+    );
+}
+
+void Application::handle_evdev_events(
+    device_handle handle,
+    const asio::error_code & error,
+    const evdev_event_results<asio::mutable_buffers_1> & results
+) {
+    evdev_type * const evdev = m_evdevs.get(handle);
+    if (!evdev) {
+        return;
+    }
+    if (!error) {
+        capture(capture_format::kind_type::evdev, handle.index, results);
+        process_evdev_events(handle, *evdev, results);
+        async_read_evdev_events(handle, *evdev);
+    } else {
+        finish(m_evdevs, handle, *evdev);
+    }
+}
+
+void Application::process_evdev_events(
+    device_handle handle,
+    evdev_type & evdev,
+    const evdev_event_results<asio::mutable_buffers_1> & results
+) {
+    const std::uint64_t now = monotonic_now();
+    // Events accumulate until the SYN_REPORT that closes their frame, so each frame is published once
+    for (auto event = results.begin(); event != results.end(); ++event) {
+        if (event->type == EV_SYN) {
+            if (event->code == SYN_DROPPED) {
+                evdev.dropped = true;
+                evdev.events.clear();
+            } else if (event->code == SYN_REPORT) {
+                if (evdev.dropped) {
+                    evdev.dropped = false;
+                    synchronize(evdev);
                 }
-                break;
+                publish(handle, evdev.events, source_type::evdev);
             }
+        } else if (evdev.dropped) {
+            continue;
+        } else if (event->type == EV_KEY && event->code < KEY_CNT && evdev.buttons[event->code] >= 0) {
+            struct js_event translated;
+            translated.time = milliseconds(*event);
+            translated.value = event->value ? 1 : 0;
+            translated.type = JS_EVENT_BUTTON;
+            translated.number = evdev.buttons[event->code];
+            evdev.events.insert(translated, evdev.monotonic ? nanoseconds(*event) : now);
+        } else if (event->type == EV_ABS && event->code < ABS_CNT && evdev.axes[event->code] >= 0) {
+            struct js_event translated;
+            translated.time = milliseconds(*event);
+            translated.value = normalize(event->value, evdev.absinfo[event->code]);
+            translated.type = JS_EVENT_AXIS;
+            translated.number = evdev.axes[event->code];
+            evdev.events.insert(translated, evdev.monotonic ? nanoseconds(*event) : now);
+        }
+    }
+}
+
+void Application::synchronize(evdev_type & evdev) {
+    // A replayed device has no descriptor to query, so it keeps the state its recorded events left
+    if (!evdev.descriptor.is_open()) {
+        return;
+    }
+    // Resend the full device state as JS_EVENT_INIT events, as joydev does on open
+    evdev.events.clear();
+    asio::error_code ec;
+    const evdev_descriptor::bits_type keys = evdev.descriptor.key_state(ec);
+    const struct timespec now = [](){
+        struct timespec now;
+        ::clock_gettime(CLOCK_MONOTONIC, &now);
+        return now;
+    }();
+    const std::uint32_t time = static_cast<std::uint32_t>(std::uint64_t(now.tv_sec) * 1000 + now.tv_nsec / 1000000);
+    for (std::size_t code = 0; code != KEY_CNT; ++code) {
+        if (evdev.buttons[code] >= 0) {
+            struct js_event event;
+            event.time = time;
+            event.value = !ec && evdev_descriptor::test(keys, code) ? 1 : 0;
+            event.type = JS_EVENT_BUTTON | JS_EVENT_INIT;
+            event.number = evdev.buttons[code];
+            evdev.events.insert(event);
+        }
+    }
+    for (std::size_t code = 0; code != ABS_CNT; ++code) {
+        if (evdev.axes[code] >= 0) {
+            asio::error_code absinfo_ec;
+            const struct input_absinfo absinfo = evdev.descriptor.absinfo(code, absinfo_ec);
+            if (!absinfo_ec) {
+                evdev.absinfo[code] = absinfo;
+            }
+            struct js_event event;
+            event.time = time;
+            event.value = normalize(evdev.absinfo[code].value, evdev.absinfo[code]);
+            event.type = JS_EVENT_AXIS | JS_EVENT_INIT;
+            event.number = evdev.axes[code];
+            evdev.events.insert(event);
         }
-        buffer->consume(sizeof(struct js_event));
-        async_read_joystick_events(joystick, buffer);
-    } else {
-        std::cout << '-'
-            << "joystick: " << joystick.get() << std::endl;
-        m_joysticks.erase(joystick->key);
+    }
+}
+
+void Application::publish(device_handle handle, joystick_event_coalescer & events, source_type source) {
+    if (m_logger.enabled(event_logger::level_type::event)) {
+        events.for_each([this,&handle](const struct js_event & event, std::uint64_t){
+            m_logger.joystick(handle.index, event);
+        });
+    }
+    if (!events.empty()) {
+        m_leds.modify([this,&events,source](frame_type & leds){
+            events.for_each([this,&leds,source](const struct js_event & event, std::uint64_t stamp){
+                switch(event.type & ~JS_EVENT_INIT) {
+                case JS_EVENT_BUTTON:
+                    light(leds, m_map.find(led_map::class_type::joystick, led_map::event_type::button, event.number).positive, event.value ? 0xff : 0, source, stamp);
+                    break;
+                case JS_EVENT_AXIS:
+                    if (m_chip.is_open()) {
+                        const led_map::binding_type & binding = m_map.find(led_map::class_type::joystick, led_map::event_type::axis, event.number);
+                        const std::uint8_t magnitude = std::min(std::abs(event.value) * 0xff / 0x7fff, 0xff);
+                        light(leds, binding.negative, event.value < 0 ? magnitude : 0, source, stamp);
+                        light(leds, binding.positive, event.value > 0 ? magnitude : 0, source, stamp);
+                    }
+                    break;
+                }
+            });
+        });
+        events.clear();
     }
 }
 
 void Application::async_read_gpio_line_events(
-    gpio_line_descriptor & line,
-    const std::shared_ptr<asio::streambuf> & buffer
+    gpio_line_descriptor & line
 ) {
     line.async_read_line_events(
-        asio::buffer(buffer->prepare(sizeof(struct gpioevent_data) * 16)),
-        [this,buffer,&line](const asio::error_code & error, const gpio_line_event_results<asio::mutable_buffers_1> & results){
-            handle_read_gpio_line_events(line, buffer, error, results);
-        }
+        asio::buffer(m_gpio_buffer),
+        asio::bind_executor(m_gpio, make_custom_alloc_handler(m_gpio_memory, [this,&line](const asio::error_code & error, const gpio_line_event_results<asio::mutable_buffers_1> & results){
+            handle_read_gpio_line_events(line, error, results);
+        }))
     );
 }
 
 void Application::handle_read_gpio_line_events(
     gpio_line_descriptor & line,
-    const std::shared_ptr<asio::streambuf> & buffer,
     const asio::error_code & error,
     const gpio_line_event_results<asio::mutable_buffers_1> & results
 ) {
     if (!error) {
-        for (auto event = results.begin(); event != results.end(); ++event) {
-            std::cout << ' '
-                << "timestamp_ns: " << event->timestamp_ns << ", "
-                << "id: " << event->id << ", "
-                << "offset: " << event->offset << ", "
-                << "seqno: " << event->seqno << ", "
-                << "line_seqno: " << event->line_seqno << std::endl;
-            if (event->id == GPIO_V2_LINE_EVENT_RISING_EDGE) {
-                switch(event->offset) {
-                case s_inputs[0]:
-                    /*
-                    static constexpr const std::chrono::microseconds s_inc(100);
-                    static constexpr const std::chrono::microseconds s_min(s_inc);
-                    static constexpr const std::chrono::microseconds s_max(1000 - s_min.count());
-                    if (m_mark.first <= s_max) {
-                        m_mark.first += s_inc;
-                        m_mark.second -= s_inc;
-                        std::cout << "Brightness: " << m_mark.first.count() << std::endl;
-                    }
-                    */
-                    break;
-                case s_inputs[1]:
-                    /*
-                    if (m_mark.first >= s_min) {
-                        m_mark.first -= s_inc;
-                        m_mark.second += s_inc;
-                        std::cout << "Brightness: " << m_mark.first.count() << std::endl;
-                    }
-                    */
-                    break;
-
-                case s_inputs[2]:
-                    break;
-                case s_inputs[3]:
-                    break;
-                }
-            }
-        }
-        buffer->consume(sizeof(struct gpioevent_data) * 16);
-        async_read_gpio_line_events(line, buffer);
+        capture(capture_format::kind_type::gpio, 0, results);
+        process_gpio_line_events(results);
+        async_read_gpio_line_events(line);
     } else if (error != asio::error::operation_aborted) {
         m_context.stop();
     }
 }
 
+void Application::process_gpio_line_events(
+    const gpio_line_event_results<asio::mutable_buffers_1> & results
+) {
+    for (auto event = results.begin(); event != results.end(); ++event) {
+        m_sequence.record(*event);
+        m_debouncer.push(*event, [this](const struct gpio_v2_line_event & event){
+            process_gpio_line_event(event);
+        });
+    }
+    async_wait_debounce();
+}
+
+void Application::process_gpio_line_event(const struct gpio_v2_line_event & event) {
+    m_logger.gpio(event);
+    // Inputs are pulled up, so a falling edge is a press
+    const led_map::mask_type mask = m_map.find(led_map::class_type::gpio, led_map::event_type::button, event.offset).positive;
+    if (mask) {
+        m_leds.modify([this,&event,mask](frame_type & leds){
+            light(leds, mask, event.id == GPIO_V2_LINE_EVENT_FALLING_EDGE ? 0xff : 0, source_type::gpio, event.timestamp_ns);
+        });
+    }
+}
+
+void Application::async_wait_debounce() {
+    // Held edges only ever settle later than the earliest one, so a pending wait never has to be brought forward
+    const std::optional<std::uint64_t> deadline = m_debouncer.deadline();
+    if (m_debouncing || !deadline) {
+        return;
+    }
+    m_debouncing = true;
+    m_debounce_timer.expires_at(asio::steady_timer::time_point(std::chrono::duration_cast<asio::steady_timer::duration>(std::chrono::nanoseconds(*deadline))));
+    m_debounce_timer.async_wait(asio::bind_executor(m_gpio, make_custom_alloc_handler(m_debounce_memory, [this](const asio::error_code & error){
+        m_debouncing = false;
+        if (!error) {
+            m_debouncer.settle(monotonic_now(), [this](const struct gpio_v2_line_event & event){
+                process_gpio_line_event(event);
+            });
+            async_wait_debounce();
+        }
+    })));
+}
+
 void Application::resync() {
+    std::vector<std::string> names;
     if (DIR * const dir = ::opendir("/dev/input")) {
         struct dirent * entry;
         while ((entry = readdir(dir)) != NULL) {
-            if (entry->d_type == DT_CHR) {
-                insert(entry->d_name);
+            if (entry->d_type == DT_CHR && is_device(device_prefix(m_input_type), entry->d_name)) {
+                names.emplace_back(entry->d_name);
             }
         }
         closedir(dir);
     }
+
+    // Drop devices whose node vanished or now refers to another device, then probe only the new names
+    std::vector<std::string> removed;
+    for (const auto & [name, handle] : m_devices) {
+        const key_type * const key = this->key(handle);
+        struct stat stat;
+        if (
+            !key ||
+            std::find(names.begin(), names.end(), name) == names.end() ||
+            ::stat(device_path(name).c_str(), &stat) == -1 ||
+            std::make_pair(stat.st_dev, stat.st_ino) != *key
+        ) {
+            removed.push_back(name);
+        }
+    }
+    for (const std::string & name : removed) {
+        remove(name);
+    }
+    for (const std::string & name : names) {
+        insert(name);
+    }
 }
 
 void Application::insert(std::string_view name) {
-    using namespace std::literals;
-    static constexpr const std::string_view input = "/dev/input/"sv;
-
-    if (std::regex_match(name.begin(), name.end(), std::regex("js\\d+"))) {
-        char path[input.size() + name.size() + 1];
-        std::strncpy(path, input.data(), input.size());
-        std::strncpy(path + input.size(), name.data(), name.size());
-        path[input.size() + name.size()] = '\0';
-        const int fd = ::open(path, O_RDONLY);
+    if (is_device(device_prefix(m_input_type), name) && m_devices.find(std::string(name)) == m_devices.end()) {
+        const int fd = ::open(device_path(name).c_str(), O_RDONLY);
         if (fd != -1) {
             struct stat stat;
             if (::fstat(fd, &stat) != -1) {
-                const decltype(joystick_type::key) joystick_key = std::make_pair(stat.st_dev, stat.st_ino);
-                if (m_joysticks.find(joystick_key) == m_joysticks.end()) {
-                    const std::shared_ptr joystick = std::make_shared<joystick_type>(
-                        joystick_type{joystick_key, joystick_descriptor(m_context, fd)}
-                    );
-
-                    std::cout<< '+'
-                        << "joystick: " << joystick.get() << ", "
-                        << "name: \"" << joystick->descriptor.name().data() << "\", "
-                        << "version: 0x" << std::hex << joystick->descriptor.version() << std::dec << ", "
-                        << "axes: " << static_cast<unsigned>(joystick->descriptor.axes()) << ", "
-                        << "buttons: " << static_cast<unsigned>(joystick->descriptor.buttons()) << std::endl;
-
-                    m_joysticks.emplace(joystick_key, joystick);
-                    async_read_joystick_events(joystick, std::make_shared<asio::streambuf>());
+                const key_type key(stat.st_dev, stat.st_ino);
+                const std::optional<device_handle> handle = m_input_type == Arguments::input_type::evdev ?
+                    insert_evdev(key, name, fd) :
+                    insert_joystick(key, name, fd);
+                if (handle) {
+                    m_devices.emplace(std::string(name), *handle);
                     return;
                 }
             }
@@ -368,18 +817,460 @@ void Application::insert(std::string_view name) {
     }
 }
 
-void Application::update() {
-    for (const led_type & led : m_leds) {
-        if (led.state) {
-            enable(led.charlie);
-            disable();
+std::optional<device_handle> Application::insert_joystick(const key_type & key, std::string_view name, int fd) {
+    const std::optional<device_handle> handle = m_joysticks.emplace(key, m_context, name, fd);
+    if (handle) {
+        joystick_type & joystick = *m_joysticks.get(*handle);
+
+        m_logger.added(
+            handle->index,
+            joystick.descriptor.name().data(),
+            joystick.descriptor.version(),
+            joystick.descriptor.axes(),
+            joystick.descriptor.buttons()
+        );
+
+        attach(joystick.descriptor, name);
+        joystick.reading = true;
+        async_read_joystick_events(*handle, joystick);
+    }
+    return handle;
+}
+
+std::optional<device_handle> Application::insert_evdev(const key_type & key, std::string_view name, int fd) {
+    const std::optional<device_handle> handle = m_evdevs.emplace(key, m_context, name, fd);
+    if (!handle) {
+        return handle;
+    }
+    evdev_type & evdev = *m_evdevs.get(*handle);
+
+    // Only take devices joydev would, leaving touchpads and plain keyboards alone
+    asio::error_code ec;
+    const evdev_descriptor::bits_type keys = evdev.descriptor.bits(EV_KEY, ec);
+    const evdev_descriptor::bits_type axes = ec ? evdev_descriptor::bits_type{} : evdev.descriptor.bits(EV_ABS, ec);
+    bool joystick = !ec && evdev_descriptor::test(axes, ABS_X);
+    for (std::size_t code = BTN_JOYSTICK; code != BTN_DIGI; ++code) {
+        joystick = joystick || evdev_descriptor::test(keys, code);
+    }
+    if (ec || !joystick || evdev_descriptor::test(keys, BTN_TOUCH)) {
+        evdev.descriptor.release();
+        m_evdevs.erase(*handle);
+        return std::nullopt;
+    }
+
+    std::size_t buttons = 0;
+    evdev.buttons.fill(-1);
+    for (std::size_t code = BTN_JOYSTICK; code != KEY_CNT; ++code) {
+        if (evdev_descriptor::test(keys, code) && buttons != 0x100) {
+            evdev.buttons[code] = buttons++;
+        }
+    }
+    for (std::size_t code = BTN_MISC; code != BTN_JOYSTICK; ++code) {
+        if (evdev_descriptor::test(keys, code) && buttons != 0x100) {
+            evdev.buttons[code] = buttons++;
+        }
+    }
+    std::size_t axes_count = 0;
+    evdev.axes.fill(-1);
+    for (std::size_t code = 0; code != ABS_CNT; ++code) {
+        if (evdev_descriptor::test(axes, code) && axes_count != 0x100) {
+            evdev.axes[code] = axes_count++;
+        }
+    }
+
+    // Timestamp events on the clock the scanner runs on; older kernels keep CLOCK_REALTIME
+    evdev.descriptor.clock(CLOCK_MONOTONIC, ec);
+    evdev.monotonic = !ec;
+
+    // Replays need the mapping to decode this device's events
+    if (m_recorder.is_open()) {
+        std::array<char, sizeof(evdev.buttons) + sizeof(evdev.axes) + sizeof(evdev.absinfo)> mapping;
+        std::memcpy(mapping.data(), evdev.buttons.data(), sizeof(evdev.buttons));
+        std::memcpy(mapping.data() + sizeof(evdev.buttons), evdev.axes.data(), sizeof(evdev.axes));
+        std::memcpy(mapping.data() + sizeof(evdev.buttons) + sizeof(evdev.axes), evdev.absinfo.data(), sizeof(evdev.absinfo));
+        capture(capture_format::kind_type::evdev_device, handle->index, mapping.data(), mapping.size());
+    }
+
+    m_logger.added(
+        handle->index,
+        evdev.descriptor.name(ec).data(),
+        evdev.descriptor.version(ec),
+        axes_count,
+        buttons
+    );
+
+    synchronize(evdev);
+    publish(*handle, evdev.events, source_type::evdev);
+    attach(evdev.descriptor, name);
+    evdev.reading = true;
+    async_read_evdev_events(*handle, evdev);
+    return handle;
+}
+
+void Application::remove(std::string_view name) {
+    const auto device = m_devices.find(std::string(name));
+    if (device != m_devices.end()) {
+        if (m_input_type == Arguments::input_type::evdev) {
+            close(m_evdevs, device->second);
+        } else {
+            close(m_joysticks, device->second);
         }
     }
-    asio::post(m_context, [this](){
-        update();
+}
+
+template<typename Table>
+void Application::close(Table & table, device_handle handle) {
+    // Runs on the registry strand; the entry is released once its own strand has nothing left queued for it
+    typename Table::value_type * const device = table.get(handle);
+    if (!device || device->closing) {
+        return;
+    }
+    device->closing = true;
+    m_logger.removed(handle.index);
+    const auto name = m_devices.find(device->name);
+    if (name != m_devices.end() && name->second == handle) {
+        m_devices.erase(name);
+    }
+    asio::post(device->strand, [this,&table,handle,device](){
+        device->closed = true;
+        asio::error_code ec;
+        device->descriptor.close(ec);
+        if (!device->reading) {
+            asio::post(m_registry, [&table,handle](){
+                table.erase(handle);
+            });
+        }
     });
 }
 
+template<typename Table>
+void Application::finish(Table & table, device_handle handle, typename Table::value_type & device) {
+    // Runs on the device strand when its read chain ends; the pending close, if any, then releases the entry
+    device.reading = false;
+    if (device.closed) {
+        asio::post(m_registry, [&table,handle](){
+            table.erase(handle);
+        });
+    } else {
+        asio::post(m_registry, [this,&table,handle](){
+            close(table, handle);
+        });
+    }
+}
+
+const Application::key_type * Application::key(device_handle handle) const {
+    return m_input_type == Arguments::input_type::evdev ? m_evdevs.key(handle) : m_joysticks.key(handle);
+}
+
+void Application::async_replay() {
+    // A fast replay runs records back to back on the registry strand, so the strand never queues behind itself
+    while (!m_closing) {
+        const std::optional<capture_reader::entry_type> entry = m_replayer.next();
+        if (!entry) {
+            const std::chrono::duration<double> elapsed = scan_scheduler::clock_type::now() - m_replay_start;
+            std::cout << ' '
+                << "replay: records: " << m_replay_records << ", "
+                << "elapsed: " << elapsed.count() << "s" << std::endl;
+            if (m_replay_pace == Arguments::pace_type::fast) {
+#if defined(TRAFFIC_COUNT_ALLOCATIONS)
+                // The first pass creates every device, strand and per-thread buffer, the second must not allocate at all
+                if (!m_replay_warm) {
+                    m_replay_warm = true;
+                    m_replay_records = 0;
+                    m_replayer.rewind();
+                    warm_threads();
+                    return;
+                }
+                const allocation_counter::count_type allocations = allocation_counter::count();
+                std::cout << ' '
+                    << "replay: allocations: " << allocations << std::endl;
+                if (allocations) {
+                    std::cerr << "replay allocated after warming up, aborting" << std::endl;
+                    std::quick_exit(EXIT_FAILURE);
+                }
+#endif
+                m_context.stop();
+            }
+            return;
+        }
+        if (m_replay_records++ == 0) {
+            m_replay_origin = entry->stamp;
+            m_replay_start = scan_scheduler::clock_type::now();
+        }
+        if (m_replay_pace == Arguments::pace_type::fast) {
+            if (!replay(*entry)) {
+                return;
+            }
+        } else {
+            m_replay_timer.expires_at(m_replay_start + std::chrono::nanoseconds(entry->stamp - m_replay_origin));
+            m_replay_timer.async_wait(asio::bind_executor(m_registry, make_custom_alloc_handler(m_replay_memory, [this,entry=*entry](const asio::error_code & error){
+                if (!error && replay(entry)) {
+                    async_replay();
+                }
+            })));
+            return;
+        }
+    }
+}
+
+#if defined(TRAFFIC_COUNT_ALLOCATIONS)
+void Application::warm_threads() {
+    // Each handler holds its thread until all have started, so every io thread runs exactly one
+    m_warming = 0;
+    for (unsigned i = 0; i != m_threads; ++i) {
+        asio::post(m_context, [this](){
+            m_logger.claim();
+            if (m_warming.fetch_add(1, std::memory_order_acq_rel) + 1 != m_threads) {
+                while (m_warming.load(std::memory_order_acquire) < m_threads && !m_context.stopped()) {
+                    std::this_thread::yield();
+                }
+                return;
+            }
+            allocation_counter::arm();
+            asio::post(m_registry, make_custom_alloc_handler(m_replay_memory, [this](){
+                async_replay();
+            }));
+        });
+    }
+}
+#endif
+
+bool Application::replay(const capture_reader::entry_type & entry) {
+    // Records decode straight out of the private mapping, through the same processing as live reads
+    const auto replayed = m_replayed.find(entry.device);
+    switch (entry.kind) {
+    case capture_format::kind_type::joystick: {
+        std::optional<device_handle> handle;
+        if (replayed != m_replayed.end() && m_joysticks.get(replayed->second)) {
+            handle = replayed->second;
+        } else {
+            handle = m_joysticks.emplace(key_type(0, entry.device), m_context, "replay");
+            if (!handle) {
+                break;
+            }
+            m_replayed[entry.device] = *handle;
+        }
+        const asio::mutable_buffers_1 buffers = whole_records<struct js_event>(entry);
+        process_joystick_events(
+            *handle,
+            *m_joysticks.get(*handle),
+            joystick_event_results<asio::mutable_buffers_1>(detail::buffers_begin(buffers), detail::buffers_end(buffers))
+        );
+        break;
+    }
+    case capture_format::kind_type::evdev_device: {
+        // A device seen before is reset in place, so replaying it again needs no new strand
+        std::optional<device_handle> handle;
+        if (replayed != m_replayed.end() && m_evdevs.get(replayed->second)) {
+            handle = replayed->second;
+        } else {
+            handle = m_evdevs.emplace(key_type(0, entry.device), m_context, "replay");
+            if (!handle) {
+                break;
+            }
+            m_replayed[entry.device] = *handle;
+        }
+        evdev_type & evdev = *m_evdevs.get(*handle);
+        evdev.events.clear();
+        evdev.dropped = false;
+        if (entry.size == sizeof(evdev.buttons) + sizeof(evdev.axes) + sizeof(evdev.absinfo)) {
+            std::memcpy(evdev.buttons.data(), entry.data, sizeof(evdev.buttons));
+            std::memcpy(evdev.axes.data(), entry.data + sizeof(evdev.buttons), sizeof(evdev.axes));
+            std::memcpy(evdev.absinfo.data(), entry.data + sizeof(evdev.buttons) + sizeof(evdev.axes), sizeof(evdev.absinfo));
+        } else {
+            evdev.buttons.fill(-1);
+            evdev.axes.fill(-1);
+        }
+        break;
+    }
+    case capture_format::kind_type::evdev:
+        if (replayed != m_replayed.end()) {
+            if (evdev_type * const evdev = m_evdevs.get(replayed->second)) {
+                const asio::mutable_buffers_1 buffers = whole_records<struct input_event>(entry);
+                process_evdev_events(
+                    replayed->second,
+                    *evdev,
+                    evdev_event_results<asio::mutable_buffers_1>(detail::buffers_begin(buffers), detail::buffers_end(buffers))
+                );
+            }
+        }
+        break;
+    case capture_format::kind_type::gpio:
+        // GPIO input state belongs to its strand, so the replay continues from there once the record is processed.
+        // Deferring each hop queues it only after the strand being left has finished, so neither strand finds work
+        // waiting on exit and reschedules itself through the per-thread cache
+        asio::defer(m_gpio, make_custom_alloc_handler(m_replay_memory, [this,entry](){
+            const asio::mutable_buffers_1 buffers = whole_records<struct gpio_v2_line_event>(entry);
+            // Edges are stamped in the recording's clock, so move them to now, keeping how long before the read each happened
+            const std::uint64_t now = monotonic_now();
+            struct gpio_v2_line_event * const events = static_cast<struct gpio_v2_line_event *>(buffers.data());
+            for (std::size_t i = 0; i != buffers.size() / sizeof(struct gpio_v2_line_event); ++i) {
+                events[i].timestamp_ns = now - std::min(entry.stamp - std::min<std::uint64_t>(events[i].timestamp_ns, entry.stamp), now);
+            }
+            process_gpio_line_events(
+                gpio_line_event_results<asio::mutable_buffers_1>(detail::buffers_begin(buffers), detail::buffers_end(buffers))
+            );
+            asio::defer(m_registry, make_custom_alloc_handler(m_replay_memory, [this](){
+                async_replay();
+            }));
+        }));
+        return false;
+    case capture_format::kind_type::inotify:
+        // Hotplug is not replayed, since processing it would probe the devices of this machine
+        break;
+    }
+    return true;
+}
+
+void Application::async_update() {
+    m_scheduler.async_wait(m_span, make_custom_alloc_handler(m_scan_memory, [this](const asio::error_code & error){
+        update(error);
+    }));
+}
+
+void Application::update(const asio::error_code & error) {
+    if (!error) {
+        step();
+        async_update();
+    } else if (error != asio::error::operation_aborted) {
+        m_context.stop();
+    }
+}
+
+void Application::scan(std::optional<unsigned> cpu, std::optional<int> priority) {
+    const pthread_t thread = ::pthread_self();
+    if (cpu) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(*cpu, &cpus);
+        if (const int error = ::pthread_setaffinity_np(thread, sizeof(cpus), &cpus)) {
+            std::cout << ' '
+                << "scan: cpu: " << *cpu << " unavailable, "
+                << "continuing unpinned: " << std::strerror(error) << std::endl;
+        }
+    }
+    if (priority) {
+        struct sched_param param;
+        std::memset(&param, 0, sizeof(param));
+        param.sched_priority = *priority;
+        if (const int error = ::pthread_setschedparam(thread, SCHED_FIFO, &param)) {
+            std::cout << ' '
+                << "scan: priority: " << *priority << " unavailable, "
+                << "continuing with default scheduling: " << std::strerror(error) << std::endl;
+        }
+    }
+
+    try {
+        while (m_scanning.load(std::memory_order_relaxed)) {
+            m_scheduler.wait(m_span);
+            step();
+        }
+        disable();
+    } catch (const asio::system_error & error) {
+        std::cout << ' '
+            << "scan: " << error.what() << std::endl;
+        m_context.stop();
+    }
+}
+
+void Application::plan(const frame_type & leds) {
+    std::array<std::uint8_t, std::tuple_size_v<frame_type>> levels;
+    bool binary = true;
+    for (frame_type::size_type i = 0; i != leds.size(); ++i) {
+        levels[i] = s_gamma[leds[i].level];
+        binary = binary && (levels[i] == 0 || levels[i] == 0xff);
+    }
+
+    // A frame of fully on and fully off LEDs has identical bit-planes, so one pass is enough
+    m_planes = binary ? 1 : m_plan.size();
+    m_dark = 0;
+    for (frame_type::size_type i = 0; i != levels.size(); ++i) {
+        m_dark |= levels[i] ? 0 : std::uint32_t(1) << i;
+    }
+    for (std::size_t plane = 0; plane != m_planes; ++plane) {
+        const std::uint8_t bit = binary ? 0x80 : 1 << plane;
+        m_lit[plane] = 0;
+        for (frame_type::size_type i = 0; i != levels.size(); ++i) {
+            m_lit[plane] |= (levels[i] & bit) ? std::uint32_t(1) << i : 0;
+        }
+        if (m_scan == Arguments::scan_type::row) {
+            for (std::size_t anode = 0; anode != s_outputs.size(); ++anode) {
+                std::uint64_t cathodes = 0;
+                for (frame_type::size_type i = 0; i != levels.size(); ++i) {
+                    if ((levels[i] & bit) && s_charlies[i].first == anode) {
+                        cathodes |= std::uint64_t(1) << s_charlies[i].second;
+                    }
+                }
+                m_plan[plane][anode] = cathodes ? &s_rows[anode][cathodes] : nullptr;
+            }
+        } else {
+            for (frame_type::size_type i = 0; i != levels.size(); ++i) {
+                m_plan[plane][i] = (levels[i] & bit) ? &s_slots[i] : nullptr;
+            }
+        }
+    }
+}
+
+void Application::step() {
+    const scan_scheduler::time_point start = scan_scheduler::clock_type::now();
+    if (m_slot == 0 && m_plane == 0) {
+        const frame_type * const frame = &m_leds.acquire();
+        if (frame != m_frame) {
+            m_frame = frame;
+            plan(*frame);
+        }
+    }
+
+    const struct gpio_v2_line_config * const config = m_plan[m_plane][m_slot];
+    if (config) {
+        enable(*config);
+    } else {
+        disable();
+    }
+    trace();
+    // Bit-plane n of a dimmed frame stays lit for 2^n/255 of a period, so a slot's eight planes add up to one
+    // period and a dimmed frame takes as long as a binary one, whose single plane holds the whole period
+    m_span = m_planes == 1 ? m_scheduler.period() : m_scheduler.period() * (1 << m_plane) / 255;
+    if (++m_slot == m_steps) {
+        m_slot = 0;
+        if (++m_plane == m_planes) {
+            m_plane = 0;
+            m_scheduler.frame();
+            m_frame_time.record(std::chrono::nanoseconds(start - m_frame_start).count());
+            m_frame_start = start;
+        }
+    }
+    m_step_time.record(std::chrono::nanoseconds(scan_scheduler::clock_type::now() - start).count());
+
+    m_scheduler.tick();
+    if (m_scheduler.elapsed() >= s_report_period) {
+        const scan_scheduler::statistics_type statistics = m_scheduler.sample();
+        std::cout << ' '
+            << "scan: " << statistics.rate << "Hz, "
+            << "frames: " << statistics.frame_rate << "Hz, "
+            << "missed: " << statistics.missed << ", "
+            << "writes: " << m_lines.configs_written() << ", "
+            << "elided: " << m_lines.configs_elided() << std::endl;
+    }
+}
+
+void Application::trace() {
+    // An LED first shows its new level in the first plane it is lit in, or in the first plane if it is dark
+    const std::uint32_t shown = m_lit[m_plane] | (m_plane == 0 ? m_dark : 0);
+    if (!shown) {
+        return;
+    }
+    const std::uint64_t now = monotonic_now();
+    for (frame_type::size_type i = 0; i != m_frame->size(); ++i) {
+        const led_type & led = (*m_frame)[i];
+        const bool driven = m_scan == Arguments::scan_type::row ? s_charlies[i].first == m_slot : i == m_slot;
+        if (driven && (shown >> i & 1) && led.stamp && led.stamp != m_traced[i]) {
+            m_traced[i] = led.stamp;
+            m_latency[static_cast<std::size_t>(led.source)].record(now - std::min(led.stamp, now));
+        }
+    }
+}
+
 /*
 void Application::pwm() {
     struct gpio_v2_line_values brightness_line_values;
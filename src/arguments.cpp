@@ -1,8 +1,36 @@
+#include <algorithm>
+#include <charconv>
 #include <cstdlib>
 #include <iostream>
+#include <thread>
 
 #include "arguments.hpp"
 
+namespace {
+
+template<typename T>
+T parse(std::string_view option, std::string_view value) {
+    T result;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+    if (error != std::errc() || end != value.data() + value.size()) {
+        std::cerr << "invalid value for " << option << ": \"" << value << "\", aborting" << std::endl;
+        std::quick_exit(EXIT_FAILURE);
+    }
+    return result;
+}
+
+template<typename Iterator>
+std::string_view next(Iterator & arg, const Iterator & end) {
+    const std::string_view option = *arg;
+    if (++arg == end) {
+        std::cerr << "missing value for " << option << ", aborting" << std::endl;
+        std::quick_exit(EXIT_FAILURE);
+    }
+    return *arg;
+}
+
+} // namespace
+
 Arguments::Arguments(std::string_view name, const std::vector<std::string_view> & args) :
     name(name)
 {
@@ -10,21 +38,145 @@ Arguments::Arguments(std::string_view name, const std::vector<std::string_view>
         if (*arg == "--help" || *arg == "-h") {
             help();
             std::quick_exit(EXIT_SUCCESS);
+        } else if (*arg == "--rate" || *arg == "-r") {
+            const std::string_view option = *arg;
+            rate = parse<unsigned>(option, next(arg, args.end()));
+            // The least significant bit-plane lasts 1/255 of a period, which must not truncate to zero
+            if (rate == 0 || rate > 1000000000 / 255) {
+                std::cerr << "invalid value for " << option << ": \"" << *arg << "\", aborting" << std::endl;
+                std::quick_exit(EXIT_FAILURE);
+            }
+        } else if (*arg == "--threads" || *arg == "-t") {
+            const std::string_view option = *arg;
+            threads = parse<unsigned>(option, next(arg, args.end()));
+        } else if (*arg == "--io-uring") {
+            io_uring = true;
+        } else if (*arg == "--scan" || *arg == "-s") {
+            const std::string_view option = *arg;
+            const std::string_view value = next(arg, args.end());
+            if (value == "led") {
+                scan = scan_type::led;
+            } else if (value == "row") {
+                scan = scan_type::row;
+            } else {
+                std::cerr << "invalid value for " << option << ": \"" << value << "\", aborting" << std::endl;
+                std::quick_exit(EXIT_FAILURE);
+            }
+        } else if (*arg == "--scan-thread") {
+            scan_thread = true;
+        } else if (*arg == "--scan-cpu") {
+            const std::string_view option = *arg;
+            scan_cpu = parse<unsigned>(option, next(arg, args.end()));
+            scan_thread = true;
+        } else if (*arg == "--scan-priority") {
+            const std::string_view option = *arg;
+            scan_priority = parse<int>(option, next(arg, args.end()));
+            scan_thread = true;
+        } else if (*arg == "--input" || *arg == "-i") {
+            const std::string_view option = *arg;
+            const std::string_view value = next(arg, args.end());
+            if (value == "joydev") {
+                input = input_type::joydev;
+            } else if (value == "evdev") {
+                input = input_type::evdev;
+            } else {
+                std::cerr << "invalid value for " << option << ": \"" << value << "\", aborting" << std::endl;
+                std::quick_exit(EXIT_FAILURE);
+            }
+        } else if (*arg == "--debounce") {
+            const std::string_view option = *arg;
+            debounce = parse<unsigned>(option, next(arg, args.end()));
+        } else if (*arg == "--gpio-events") {
+            const std::string_view option = *arg;
+            gpio_events = parse<unsigned>(option, next(arg, args.end()));
+        } else if (*arg == "--log-level") {
+            const std::string_view option = *arg;
+            const std::string_view value = next(arg, args.end());
+            if (value == "none") {
+                log_level = level_type::none;
+            } else if (value == "info") {
+                log_level = level_type::info;
+            } else if (value == "event") {
+                log_level = level_type::event;
+            } else {
+                std::cerr << "invalid value for " << option << ": \"" << value << "\", aborting" << std::endl;
+                std::quick_exit(EXIT_FAILURE);
+            }
+        } else if (*arg == "--map") {
+            map = next(arg, args.end());
+        } else if (*arg == "--record") {
+            record = next(arg, args.end());
+        } else if (*arg == "--replay") {
+            replay = next(arg, args.end());
+        } else if (*arg == "--replay-pace") {
+            const std::string_view option = *arg;
+            const std::string_view value = next(arg, args.end());
+            if (value == "realtime") {
+                replay_pace = pace_type::realtime;
+            } else if (value == "fast") {
+                replay_pace = pace_type::fast;
+            } else {
+                std::cerr << "invalid value for " << option << ": \"" << value << "\", aborting" << std::endl;
+                std::quick_exit(EXIT_FAILURE);
+            }
         } else {
             std::cerr << "invalid positional argument: \"" << *arg << "\", aborting" << std::endl;
             std::quick_exit(EXIT_FAILURE);
         }
     }
+    if (record && replay) {
+        std::cerr << "--record and --replay are mutually exclusive, aborting" << std::endl;
+        std::quick_exit(EXIT_FAILURE);
+    }
+}
+
+unsigned Arguments::io_threads() const {
+    return std::max(threads ? threads : std::thread::hardware_concurrency(), 1u);
 }
 
 void Arguments::help() {
     std::cerr
-        << "Usage: " << name << "[-h]\n"
+        << "Usage: " << name << "[-h] [-r HZ] [-t N] [--io-uring] [-s {led,row}]\n"
+        << "    [--scan-thread] [--scan-cpu CPU] [--scan-priority PRIORITY]\n"
+        << "    [-i {joydev,evdev}] [--debounce US] [--gpio-events N]\n"
+        << "    [--log-level {none,info,event}] [--map FILE]\n"
+        << "    [--record FILE | --replay FILE [--replay-pace {realtime,fast}]]\n"
         << '\n'
         << "Traffic Light Simulator\n"
         << '\n'
         << "Options:\n"
         << "  -h, --help            show this help message and exit\n"
+        << "  -r, --rate HZ         LED scan slots per second (default: 2000); a\n"
+        << "                        dimmed LED splits its slot into 8 bit-planes\n"
+        << "  -t, --threads N       io threads to run, or 0 for one per core\n"
+        << "                        (default: 0)\n"
+        << "  --io-uring            read devices through io_uring, falling back to\n"
+        << "                        epoll where it is unavailable\n"
+        << "  -s, --scan {led,row}  light one LED per slot, or every LED sharing\n"
+        << "                        an anode per slot (default: led)\n"
+        << "  --scan-thread         scan on a dedicated thread instead of the io threads\n"
+        << "  --scan-cpu CPU        pin the scan thread to CPU (implies --scan-thread)\n"
+        << "  --scan-priority PRIORITY\n"
+        << "                        run the scan thread as SCHED_FIFO at PRIORITY\n"
+        << "                        (implies --scan-thread)\n"
+        << "  -i, --input {joydev,evdev}\n"
+        << "                        read joysticks from /dev/input/js* or from\n"
+        << "                        /dev/input/event* (default: joydev)\n"
+        << "  --debounce US         ignore GPIO input edges within US microseconds\n"
+        << "                        of the last one (default: 5000, 0 disables)\n"
+        << "  --gpio-events N       kernel queue size for GPIO input edges\n"
+        << "                        (default: 64, 0 lets the kernel choose)\n"
+        << "  --log-level {none,info,event}\n"
+        << "                        log nothing, device hotplug only, or every\n"
+        << "                        input event as well (default: event)\n"
+        << "  --map FILE            bind buttons, axes and GPIO inputs to LEDs as\n"
+        << "                        listed in FILE instead of the built-in bindings\n"
+        << "  --record FILE         append every raw input read to capture FILE\n"
+        << "  --replay FILE         feed the input reads of capture FILE through the\n"
+        << "                        event handlers instead of reading devices\n"
+        << "  --replay-pace {realtime,fast}\n"
+        << "                        replay with the recorded timing, or as fast as\n"
+        << "                        possible and exit when done (default: realtime)\n"
         << '\n'
         << std::flush;
 }
@@ -13,13 +13,12 @@ int main(int argc, char * argv[]) {
             context.stop();
         }
     });
-    Application application(
-        context,
-        Arguments(argv[0], std::vector<std::string_view>(argv + 1, argv + argc))
-    );
+    const Arguments arguments(argv[0], std::vector<std::string_view>(argv + 1, argv + argc));
+    Application application(context, arguments);
 
     std::vector<std::thread> threads;
-    const auto cores = std::thread::hardware_concurrency();
+    const auto cores = arguments.io_threads();
+    threads.reserve(cores);
     for(std::remove_const_t<decltype(cores)> i = 0; i != cores; ++i) {
         threads.emplace_back(
             std::thread([&context](){